@@ -0,0 +1,317 @@
+#ifndef MY_DEGEN_HPP
+#define MY_DEGEN_HPP
+/**
+ * @brief namespace degen 提供了流式的结构化测试数据生成
+ *
+ * @brief 随机父节点树 random_parent_tree (可通过elongation控制树的形态)
+ * @brief 均匀随机树 prufer_tree (Prüfer序列解码)
+ * @brief 随机连通图 connected_graph
+ * @brief 随机有向无环图 dag
+ * @brief R-MAT幂律图 rmat
+ * @brief Erdős–Rényi随机图 erdos_renyi，网格图 grid，长链 chain
+ * @brief 随机字符串 random_string
+ *
+ * @note 生成器不会构造完整的边表，每生成一条边就交给sink处理
+ *       io_sink 直接写入io::的输出缓冲区，缓冲区接近写满时分块写出
+ *       graph_sink 直接调用add_edge构建到degraph::graph_t中
+ * @note 额外内存至多为O(n)(节点数)，与边数无关
+ *
+ * @example 使用示例
+ * int main()
+ * {
+ *     random_t rnd;
+ *     rnd.setSeed(20241105);
+ *     io::start_writing();
+ *     io::write_int(1 << 20), io::write_int(100000000), io::newline();
+ *     degen::rmat(rnd, 20, 100000000, degen::io_sink());
+ *     io::flush();
+ *
+ *     degraph::graph_t g;
+ *     degen::prufer_tree(rnd, 1000, degen::graph_sink<degraph::graph_t>(g, true));
+ *     return 0;
+ * }
+ */
+
+#include "DEGRAPH.hpp"
+#include "IO.hpp"
+#include "RANDOM.hpp"
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace degen {
+/**
+ * @brief 将边写入io::输出缓冲区，每行一条边"u v"
+ * @param base 输出编号的偏移量，默认输出1-indexed编号
+ */
+struct io_sink {
+    int base;
+    io_sink(int base = 1)
+        : base(base)
+    {
+    }
+    void operator()(int u, int v) const
+    {
+        io::write_int(u + base);
+        io::write_int(v + base);
+        io::newline();
+        io::flush_if_full();
+    }
+};
+
+/**
+ * @brief 将边直接添加到图中
+ * @param undirected 为true时同时添加反向边
+ */
+template <typename Graph>
+struct graph_sink {
+    Graph& g;
+    bool undirected;
+    graph_sink(Graph& g, bool undirected = false)
+        : g(g)
+        , undirected(undirected)
+    {
+    }
+    void operator()(int u, int v) const
+    {
+        g.add_edge(u, v);
+        if (undirected) {
+            g.add_edge(v, u);
+        }
+    }
+};
+
+inline void check(bool ok, const char* message)
+{
+#ifdef GXY_DEBUG
+    if (!ok) {
+        debug::cerr() << message << "\n";
+        throw std::runtime_error(message);
+    }
+#else
+    (void)ok;
+    (void)message;
+#endif
+}
+
+/**
+ * @brief 随机父节点树，节点i的父节点在[0, i-1]中选取
+ * @param n 节点数量
+ * @param elongation 传给random_t::wnext的type，正数使树更接近链，负数使树更接近菊花
+ * @param relabel 是否随机打乱节点编号(需要O(n)内存)
+ * @note 输出n-1条边(子节点, 父节点)
+ */
+template <typename Sink>
+void random_parent_tree(random_t& rnd, int n, Sink&& sink, int elongation = 0, bool relabel = true)
+{
+    check(n > 0, "random_parent_tree: n must be positive");
+    std::vector<int> label;
+    if (relabel) {
+        label = rnd.perm(n);
+    }
+    for (int i = 1; i < n; ++i) {
+        int p = elongation == 0 ? rnd.next(i) : rnd.wnext(i, elongation);
+        if (relabel) {
+            sink(label[i], label[p]);
+        } else {
+            sink(i, p);
+        }
+    }
+}
+
+/**
+ * @brief 均匀随机的带标号树，随机生成Prüfer序列后线性时间解码
+ * @param n 节点数量
+ * @note Prüfer序列不保存，解码时用rnd的副本重新生成一遍，只需要O(n)的度数数组
+ * @note 时间复杂度O(n)
+ */
+template <typename Sink>
+void prufer_tree(random_t& rnd, int n, Sink&& sink)
+{
+    check(n > 0, "prufer_tree: n must be positive");
+    if (n == 1) {
+        return;
+    }
+    random_t replay = rnd;
+    std::vector<int> degree(n, 1);
+    for (int i = 0; i < n - 2; ++i) {
+        degree[rnd.next(n)]++;
+    }
+    int ptr = 0;
+    while (degree[ptr] != 1) {
+        ptr++;
+    }
+    int leaf = ptr;
+    for (int i = 0; i < n - 2; ++i) {
+        int v = replay.next(n);
+        sink(leaf, v);
+        if (--degree[v] == 1 && v < ptr) {
+            leaf = v;
+        } else {
+            ptr++;
+            while (degree[ptr] != 1) {
+                ptr++;
+            }
+            leaf = ptr;
+        }
+    }
+    sink(leaf, n - 1);
+}
+
+/**
+ * @brief 随机连通图，先生成随机生成树，再补充随机边
+ * @param n 节点数量
+ * @param m 边数量，要求m >= n - 1
+ * @note 补充的边不判重(判重需要O(m)内存)，可能出现重边，但不会出现自环
+ */
+template <typename Sink>
+void connected_graph(random_t& rnd, int n, long long m, Sink&& sink)
+{
+    check(n > 0 && m >= n - 1, "connected_graph: m must be at least n - 1");
+    random_parent_tree(rnd, n, sink);
+    check(n > 1 || m == 0, "connected_graph: a single vertex graph can't have edges");
+    for (long long e = n - 1; e < m; ++e) {
+        int u = rnd.next(n);
+        int v = rnd.next(n - 1);
+        sink(u, v >= u ? v + 1 : v);
+    }
+}
+
+/**
+ * @brief 随机有向无环图，边总是从随机拓扑序中靠前的节点指向靠后的节点
+ * @param n 节点数量，要求n >= 2
+ * @param m 边数量
+ * @note 可能出现重边，但不会出现自环和环
+ */
+template <typename Sink>
+void dag(random_t& rnd, int n, long long m, Sink&& sink)
+{
+    check(n > 1 || m == 0, "dag: n must be at least 2");
+    std::vector<int> order = rnd.perm(n);
+    for (long long e = 0; e < m; ++e) {
+        int a = rnd.next(n);
+        int b = rnd.next(n - 1);
+        if (b >= a) {
+            b++;
+        }
+        if (a > b) {
+            std::swap(a, b);
+        }
+        sink(order[a], order[b]);
+    }
+}
+
+/**
+ * @brief R-MAT幂律图，每条边独立地在邻接矩阵中递归选择象限
+ * @param scale 节点数量为2^scale
+ * @param m 边数量
+ * @param a,b,c 左上、右上、左下象限的概率，右下象限为1-a-b-c
+ * @note 默认参数与Graph500一致，不使用额外内存
+ */
+template <typename Sink>
+void rmat(random_t& rnd, int scale, long long m, Sink&& sink,
+    double a = 0.57, double b = 0.19, double c = 0.19)
+{
+    check(scale > 0 && scale < 31, "rmat: scale must be in [1, 30]");
+    const double ab = a + b, abc = a + b + c;
+    for (long long e = 0; e < m; ++e) {
+        int u = 0, v = 0;
+        for (int bit = scale - 1; bit >= 0; --bit) {
+            double r = rnd.next();
+            if (r < a) {
+                continue;
+            } else if (r < ab) {
+                v |= 1 << bit;
+            } else if (r < abc) {
+                u |= 1 << bit;
+            } else {
+                u |= 1 << bit;
+                v |= 1 << bit;
+            }
+        }
+        sink(u, v);
+    }
+}
+
+/**
+ * @brief Erdős–Rényi随机图G(n, m)，每条边的两个端点独立均匀选取
+ * @note 可能出现重边，不会出现自环
+ */
+template <typename Sink>
+void erdos_renyi(random_t& rnd, int n, long long m, Sink&& sink)
+{
+    check(n > 1 || m == 0, "erdos_renyi: n must be at least 2");
+    for (long long e = 0; e < m; ++e) {
+        int u = rnd.next(n);
+        int v = rnd.next(n - 1);
+        sink(u, v >= u ? v + 1 : v);
+    }
+}
+
+/**
+ * @brief rows * cols的网格图，节点(i, j)的编号为i * cols + j
+ * @note 每个节点向右、向下各连一条边，共rows * (cols - 1) + (rows - 1) * cols条边
+ */
+template <typename Sink>
+void grid(int rows, int cols, Sink&& sink)
+{
+    check(rows > 0 && cols > 0, "grid: rows and cols must be positive");
+    for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < cols; ++j) {
+            const int u = i * cols + j;
+            if (j + 1 < cols) {
+                sink(u, u + 1);
+            }
+            if (i + 1 < rows) {
+                sink(u, u + cols);
+            }
+        }
+    }
+}
+
+/**
+ * @brief n个节点的链，共n - 1条边(第i个节点, 第i + 1个节点)
+ * @param relabel 是否随机打乱节点编号(需要O(n)内存)，打乱后相邻节点的编号不再相近
+ */
+template <typename Sink>
+void chain(random_t& rnd, int n, Sink&& sink, bool relabel = false)
+{
+    check(n > 0, "chain: n must be positive");
+    std::vector<int> label;
+    if (relabel) {
+        label = rnd.perm(n);
+    }
+    for (int i = 0; i + 1 < n; ++i) {
+        if (relabel) {
+            sink(label[i], label[i + 1]);
+        } else {
+            sink(i, i + 1);
+        }
+    }
+}
+
+/**
+ * @brief 随机字符串，按块写入io::输出缓冲区，最后换行
+ * @param len 字符串长度
+ * @param alphabet 字符集
+ */
+inline void random_string(random_t& rnd, long long len, const std::string& alphabet = "abcdefghijklmnopqrstuvwxyz")
+{
+    check(!alphabet.empty(), "random_string: alphabet must not be empty");
+    constexpr int BLOCK = 2048;
+    const int k = alphabet.size();
+    while (len > 0) {
+        io::flush_if_full();
+        int block = len < BLOCK ? len : BLOCK;
+        for (int i = 0; i < block; ++i) {
+            io::write_char(alphabet[rnd.next(k)]);
+        }
+        len -= block;
+    }
+    io::write_char(' ');
+    io::newline();
+    io::flush_if_full();
+}
+} // namespace degen
+
+#endif // MY_DEGEN_HPP
@@ -0,0 +1,444 @@
+#ifndef MY_DEGRAPH_HPP
+#define MY_DEGRAPH_HPP
+#include "IO.hpp"
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief 有向图
+ * @note graph_t 是一个邻接表的实现，可以快速添加边，但是删除边和查询边的效率较低
+ * @note csr_t 是只读的压缩稀疏行(CSR)快照，同一节点的边连续存放，遍历时没有指针跳转
+ *       建好图后调用graph_t::freeze()得到，适合边数很多、只遍历不修改的图
+ * @note 两种表示都提供 for_each(u, f)，对u的每条出边调用f(v, e)，e为graph_t中的边编号
+ *       遍历算法(如bfs)对两种表示写法相同
+ * @note basic_graph_t<edge_props<E...>, vertex_props<V...>> 为每种边属性和节点属性各存一列(结构体数组拆成数组结构体)
+ *       g.edge<I>()[e]为边e的第I个属性，g.vertex<I>()[u]为节点u的第I个属性
+ *       算法只读取用到的列，边带多个属性时遍历循环仍然紧凑；graph_t为不带属性的basic_graph_t<>
+ *
+ * @see DEGRAPH_DYNAMIC.hpp 支持O(1)删边的动态图
+ * @see DEGRAPH_BFS.hpp 多线程方向优化BFS
+ * @see DEGRAPH_PATH.hpp 带权图的单源最短路
+ * @see DEGRAPH_FILE.hpp 用mmap直接打开的二进制CSR图文件
+ * @see DEGRAPH_LOAD.hpp 多线程从边表文件批量建图
+ * @see DEGRAPH_ORDER.hpp 改善局部性的节点重排
+ * @see DEGRAPH_COMPONENT.hpp 无锁并查集与多线程连通分量
+ * @see DEGRAPH_SCC.hpp 强连通分量、拓扑排序与缩点
+ * @see DEGRAPH_FLOW.hpp 最大流(Dinic、预流推进)与最小割
+ * @see DEGRAPH_TREE.hpp 树上查询(O(1) LCA、重链剖分、子树区间)
+ * @see DEGRAPH_COMPRESS.hpp 差分 + varint压缩的只读邻接表
+ *
+ * @example 使用示例
+ * int main()
+ * {
+ *     degraph::graph_t g(4, 4);
+ *     g.add_edge(0, 1), g.add_edge(0, 2), g.add_edge(2, 3);
+ *     degraph::csr_t csr = g.freeze(true); // 邻接表按节点编号排序
+ *     std::vector<int> d = degraph::bfs(csr, 0); // d = { 0, 1, 1, 2 }
+ *     csr.for_each(0, [&](int v, int e) { debug::cerr() << v << "\n"; });
+ *
+ *     // 边属性为(容量, 费用)，节点属性为标签
+ *     degraph::basic_graph_t<degraph::edge_props<int, double>, degraph::vertex_props<char>> h(3, 2);
+ *     int e = h.add_edge(0, 1, 10, 2.5);
+ *     h.edge<0>()[e] -= 3, h.vertex<0>()[1] = 'x';
+ *     std::vector<double> cost = h.gather<1>(h.freeze()); // 按CSR顺序排列的费用
+ *     return 0;
+ * }
+ */
+namespace degraph {
+template <typename EdgeProps, typename VertexProps>
+struct basic_graph_t;
+
+// 是否为按头插法存储的邻接表(basic_graph_t及其派生类，dynamic_graph_t在DEGRAPH_DYNAMIC.hpp中声明)，只用于decltype
+template <typename EdgeProps, typename VertexProps>
+std::true_type is_linked_list(const basic_graph_t<EdgeProps, VertexProps>*);
+std::false_type is_linked_list(const void*);
+
+/**
+ * @brief 压缩稀疏行(CSR)表示的只读有向图
+ * @note u的出边为to[offset[u]..offset[u+1])，id为对应的graph_t边编号
+ */
+struct csr_t {
+    std::vector<int> offset; // offset[u]为u的第一条出边的位置，共vertex_size() + 1个
+    std::vector<int> to; // to[k]为第k条边指向的节点
+    std::vector<int> id; // id[k]为第k条边在原图中的编号
+
+    csr_t()
+        : offset(1, 0)
+    {
+    }
+
+    /**
+     * @brief 从任意提供vertex_size()和for_each(u, f)的图构建
+     * @param sorted 为true时每个节点的出边按指向的节点编号排序
+     * @note 只遍历原图一次，每个节点的出边依次追加，时间复杂度O(n + m)
+     *       basic_graph_t(包括graph_t)和dynamic_graph_t的邻接表按头插法存储，且不便按起点计数排序，
+     *       追加后将这一段反转，恢复成添加的顺序；其他图保持for_each的顺序
+     */
+    template <typename Graph>
+    explicit csr_t(const Graph& g, bool sorted = false)
+    {
+        const int n = g.vertex_size();
+        offset.assign(n + 1, 0);
+        to.reserve(g.edge_size());
+        id.reserve(g.edge_size());
+        for (int u = 0; u < n; ++u) {
+            g.for_each(u, [&](int v, int e) {
+                to.push_back(v);
+                id.push_back(e);
+            });
+            offset[u + 1] = to.size();
+            if constexpr (decltype(is_linked_list(&g))::value) {
+                std::reverse(to.begin() + offset[u], to.end());
+                std::reverse(id.begin() + offset[u], id.end());
+            }
+        }
+        if (sorted) {
+            sort_neighbors();
+        }
+    }
+
+    /**
+     * @brief 将每个节点的出边按指向的节点编号排序(稳定排序，重边保持原顺序)
+     */
+    void sort_neighbors()
+    {
+        std::vector<std::pair<int, int>> edges;
+        for (int u = 0; u + 1 < (int)offset.size(); ++u) {
+            const int lo = offset[u], hi = offset[u + 1];
+            if (std::is_sorted(to.begin() + lo, to.begin() + hi)) {
+                continue;
+            }
+            edges.clear();
+            for (int k = lo; k < hi; ++k) {
+                edges.emplace_back(to[k], id[k]);
+            }
+            std::stable_sort(edges.begin(), edges.end(), [](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+                return a.first < b.first;
+            });
+            for (int k = lo; k < hi; ++k) {
+                to[k] = edges[k - lo].first;
+                id[k] = edges[k - lo].second;
+            }
+        }
+    }
+
+    /**
+     * @brief 求反图，每条边u -> v变为v -> u，边编号不变
+     * @note 计数排序，时间复杂度O(n + m)，每个节点的入边按起点编号从小到大排列
+     */
+    csr_t transpose() const
+    {
+        const int n = vertex_size();
+        csr_t r;
+        r.offset.assign(n + 1, 0);
+        r.to.resize(to.size());
+        r.id.resize(id.size());
+        for (int v : to) {
+            ++r.offset[v + 1];
+        }
+        for (int v = 0; v < n; ++v) {
+            r.offset[v + 1] += r.offset[v];
+        }
+        std::vector<int> pos(r.offset.begin(), r.offset.end() - 1);
+        for (int u = 0; u < n; ++u) {
+            for (int k = offset[u]; k < offset[u + 1]; ++k) {
+                const int p = pos[to[k]]++;
+                r.to[p] = u;
+                r.id[p] = id[k];
+            }
+        }
+        return r;
+    }
+
+    int edge_size() const // 返回边的数量
+    {
+        return to.size();
+    }
+
+    int vertex_size() const // 返回节点的数量
+    {
+        return offset.size() - 1;
+    }
+
+    int degree(int u) const // 返回u的出度
+    {
+        return offset[u + 1] - offset[u];
+    }
+
+    template <typename F>
+    void for_each(int u, F&& f) const // 对u的每条出边调用f(v, e)
+    {
+        for (int k = offset[u]; k < offset[u + 1]; ++k) {
+            f(to[k], id[k]);
+        }
+    }
+};
+
+template <typename... T>
+struct edge_props { }; // 边属性的类型列表
+
+template <typename... T>
+struct vertex_props { }; // 节点属性的类型列表
+
+template <typename EdgeProps = edge_props<>, typename VertexProps = vertex_props<>>
+struct basic_graph_t;
+
+template <typename... E, typename... V>
+struct basic_graph_t<edge_props<E...>, vertex_props<V...>> {
+    std::vector<int> info; // info[i]记录i节点最后一条边在to数组中的位置
+    std::vector<int> next; // 链表中下一条边在to数组中的位置
+    std::vector<int> to; // to[i]表示编号为i的边指向的节点
+    std::tuple<std::vector<E>...> edge_columns; // 每种边属性一列，按边编号索引
+    std::tuple<std::vector<V>...> vertex_columns; // 每种节点属性一列，按节点编号索引
+
+    /**
+     * @brief Construct a new graph_t object
+     * @param n 节点数量
+     * @param m 边数量
+     */
+    basic_graph_t(int n = 0, int m = 0)
+    {
+        info.resize(n);
+        memset(info.data(), -1, sizeof(int) * n);
+        next.reserve(m);
+        to.reserve(m);
+        std::apply([&](auto&... c) { (c.reserve(m), ...); }, edge_columns);
+        std::apply([&](auto&... c) { (c.resize(n), ...); }, vertex_columns);
+    }
+
+    template <size_t I>
+    auto& edge() // 第I个边属性的列
+    {
+        return std::get<I>(edge_columns);
+    }
+    template <size_t I>
+    const auto& edge() const
+    {
+        return std::get<I>(edge_columns);
+    }
+    template <size_t I>
+    auto& vertex() // 第I个节点属性的列
+    {
+        return std::get<I>(vertex_columns);
+    }
+    template <size_t I>
+    const auto& vertex() const
+    {
+        return std::get<I>(vertex_columns);
+    }
+    /**
+     * @brief 将第I个边属性按CSR快照中边的顺序排列，之后按k连续读取
+     */
+    template <size_t I>
+    auto gather(const csr_t& csr) const
+    {
+        const auto& column = edge<I>();
+        std::remove_const_t<std::remove_reference_t<decltype(column)>> result(csr.id.size());
+        for (size_t k = 0; k < csr.id.size(); ++k) {
+            result[k] = column[csr.id[k]];
+        }
+        return result;
+    }
+
+    int edge_size() const // 返回边的数量
+    {
+        return to.size();
+    }
+
+    int vertex_size() const // 返回节点的数量(最大节点编号+1)
+    {
+        return info.size();
+    }
+    void expand(int i) // 确保info数组的大小至少为i+1(扩展图的节点数量)
+    {
+        if ((int)info.size() <= i) {
+            info.resize(i + 1, -1);
+            std::apply([&](auto&... c) { (c.resize(i + 1), ...); }, vertex_columns);
+        }
+    }
+    /**
+     * @brief 添加从i到j的边，返回边的编号
+     * @param props 边的属性，按edge_props中的顺序给出；省略时所有属性取默认值
+     */
+    template <typename... A>
+    int add_edge(int i, int j, A&&... props)
+    {
+        static_assert(sizeof...(A) == 0 || sizeof...(A) == sizeof...(E), "add_edge: wrong number of edge properties");
+        expand(i), expand(j);
+        to.push_back(j);
+        next.push_back(info[i]);
+        info[i] = to.size() - 1;
+        if constexpr (sizeof...(A) == 0) {
+            std::apply([](auto&... c) { (c.emplace_back(), ...); }, edge_columns);
+        } else {
+            push_props(std::index_sequence_for<E...>(), std::forward<A>(props)...);
+        }
+        return info[i];
+    }
+    void delete_edge(int i, int j) // 删除从i到j的边(最后添加的边)
+    {
+        int last = -1;
+        for (int k = info[i]; k >= 0; k = next[k]) {
+            if (to[k] == j) {
+                if (last == -1) {
+                    info[i] = next[k];
+                } else {
+                    next[last] = next[k];
+                }
+                return;
+            }
+            last = k;
+        }
+    }
+    template <typename F>
+    void for_each(int u, F&& f) const // 对u的每条出边调用f(v, e)，按添加顺序的逆序
+    {
+        for (int k = info[u]; k >= 0; k = next[k]) {
+            f(to[k], k);
+        }
+    }
+    /**
+     * @brief 生成CSR快照，之后对graph_t的修改不会反映到快照中
+     * @param sorted 为true时每个节点的出边按节点编号排序，否则按添加顺序
+     */
+    csr_t freeze(bool sorted = false) const
+    {
+        return csr_t(*this, sorted);
+    }
+    void clear()
+    {
+        info.clear();
+        next.resize(0);
+        to.resize(0);
+        std::apply([](auto&... c) { (c.clear(), ...); }, edge_columns);
+        std::apply([](auto&... c) { (c.clear(), ...); }, vertex_columns);
+    }
+    void print()
+    {
+        debug::cerr() << "Graph Info:\n";
+        for (int i = 0; i < info.size(); ++i) {
+            for (int j = info[i]; j >= 0; j = next[j]) {
+                debug::cerr() << i << " -> " << to[j] << "\n";
+            }
+        }
+    }
+
+private:
+    template <size_t... I, typename... A>
+    void push_props(std::index_sequence<I...>, A&&... props)
+    {
+        (std::get<I>(edge_columns).push_back(std::forward<A>(props)), ...);
+    }
+};
+
+using graph_t = basic_graph_t<>;
+
+/**
+ * @brief 带权值的CSR快照，weight与to按相同的顺序存放，遍历时连续读取
+ */
+template <typename W>
+struct weighted_csr_t : csr_t {
+    std::vector<W> weight; // weight[k]为第k条边的权值
+
+    weighted_csr_t() = default;
+
+    /**
+     * @brief 从图g构建，w[e]为g中编号为e的边的权值
+     */
+    template <typename Graph>
+    weighted_csr_t(const Graph& g, const std::vector<W>& w, bool sorted = false)
+        : csr_t(g, sorted)
+        , weight(to.size())
+    {
+        for (size_t k = 0; k < to.size(); ++k) {
+            weight[k] = w[id[k]];
+        }
+    }
+
+    template <typename F>
+    void for_each_weighted(int u, F&& f) const // 对u的每条出边调用f(v, w)
+    {
+        for (int k = offset[u]; k < offset[u + 1]; ++k) {
+            f(to[k], weight[k]);
+        }
+    }
+};
+
+/**
+ * @brief 带权有向图，边属性只有权值一列，weight()[e]为编号为e的边的权值
+ */
+template <typename W>
+struct weighted_graph_t : basic_graph_t<edge_props<W>> {
+    using basic_graph_t<edge_props<W>>::basic_graph_t;
+
+    std::vector<W>& weight()
+    {
+        return this->template edge<0>();
+    }
+    const std::vector<W>& weight() const
+    {
+        return this->template edge<0>();
+    }
+    weighted_csr_t<W> freeze(bool sorted = false) const // 生成带权值的CSR快照
+    {
+        return weighted_csr_t<W>(*this, weight(), sorted);
+    }
+};
+
+/**
+ * @brief 逐条访问出边的游标，供需要暂停遍历的迭代算法使用(如用显式栈代替递归的DFS)
+ * @note first_edge(g, u)为u的第一条出边，next_edge(g, u, k)为k之后的下一条，没有时为-1，g.to[k]为边k的终点
+ */
+inline int first_edge(const csr_t& g, int u)
+{
+    return g.offset[u] < g.offset[u + 1] ? g.offset[u] : -1;
+}
+
+inline int next_edge(const csr_t& g, int u, int k)
+{
+    return k + 1 < g.offset[u + 1] ? k + 1 : -1;
+}
+
+template <typename EdgeProps, typename VertexProps>
+int first_edge(const basic_graph_t<EdgeProps, VertexProps>& g, int u)
+{
+    return g.info[u];
+}
+
+template <typename EdgeProps, typename VertexProps>
+int next_edge(const basic_graph_t<EdgeProps, VertexProps>& g, int, int k)
+{
+    return g.next[k];
+}
+
+/**
+ * @brief 从s出发的广度优先搜索
+ * @param g graph_t或csr_t
+ * @return 每个节点到s的距离，不可达为-1
+ * @note 队列用数组实现，时间复杂度O(n + m)；在csr_t上遍历邻接表是顺序访问，比graph_t快得多
+ */
+template <typename Graph>
+std::vector<int> bfs(const Graph& g, int s)
+{
+    std::vector<int> dist(g.vertex_size(), -1), queue(g.vertex_size());
+    int head = 0, tail = 0;
+    dist[s] = 0;
+    queue[tail++] = s;
+    while (head < tail) {
+        const int u = queue[head++];
+        g.for_each(u, [&](int v, int) {
+            if (dist[v] < 0) {
+                dist[v] = dist[u] + 1;
+                queue[tail++] = v;
+            }
+        });
+    }
+    return dist;
+}
+} // namespace degraph
+
+#endif // MY_DEGRAPH_HPP
\ No newline at end of file
@@ -0,0 +1,179 @@
+#ifndef MY_DEGRAPH_BFS_HPP
+#define MY_DEGRAPH_BFS_HPP
+/**
+ * @brief 方向优化的广度优先搜索(Beamer)
+ *
+ * @brief bfs_tree 求单源的距离和BFS树中的父节点，可以多线程
+ *
+ * @note 自顶向下：遍历当前层每个节点的出边，适合层很小的时候
+ *       自底向上：每个未访问的节点遍历入边，找到一个在当前层的节点就停止，适合层很大的时候
+ *       当前层的出边数 m_f > 未访问节点的边数 m_u / BFS_ALPHA 时切换到自底向上，
+ *       当前层节点数 n_f < n / BFS_BETA 且在缩小时切回自顶向下
+ * @note 自顶向下的当前层存在队列中，用CAS抢占父节点；自底向上的当前层存在位图中，
+ *       每个线程负责连续的64位字，写下一层的位图不需要原子操作
+ * @note 低直径的大图(幂律图、随机图)上，大部分边在自底向上的几层中被跳过
+ *
+ * @example 使用示例
+ * int main()
+ * {
+ *     degraph::graph_t g(4, 4);
+ *     g.add_edge(0, 1), g.add_edge(1, 2), g.add_edge(2, 3);
+ *     degraph::csr_t out = g.freeze(), in = out.transpose();
+ *     ThreadPool pool(8);
+ *     degraph::bfs_tree_t t = degraph::bfs_tree(out, in, 0, pool);
+ *     // t.dist = { 0, 1, 2, 3 }, t.parent = { 0, 0, 1, 2 }
+ *     return 0;
+ * }
+ */
+
+#include "../MultiThread/ThreadPool.hpp"
+#include "DEGRAPH.hpp"
+#include <atomic>
+#include <vector>
+
+namespace degraph {
+constexpr int BFS_ALPHA = 15; // 切换到自底向上的阈值
+constexpr int BFS_BETA = 18; // 切换回自顶向下的阈值
+
+/**
+ * @brief BFS的结果
+ * @param dist 到源点的距离，不可达为-1
+ * @param parent BFS树中的父节点，源点的父节点为自己，不可达为-1
+ */
+struct bfs_tree_t {
+    std::vector<int> dist;
+    std::vector<int> parent;
+};
+
+/**
+ * @brief 从s出发的方向优化BFS
+ * @param out 出边
+ * @param in 入边(out.transpose())，无向图可以与out相同
+ * @param pool 线程池，为nullptr时在当前线程计算
+ * @note 多线程时同一层中哪个节点成为父节点是不确定的，但dist是确定的
+ */
+inline bfs_tree_t bfs_tree(const csr_t& out, const csr_t& in, int s, ThreadPool* pool = nullptr)
+{
+    const int n = out.vertex_size();
+    const size_t words = (n + 63) / 64;
+    bfs_tree_t t { std::vector<int>(n, -1), std::vector<int>(n, -1) };
+    int* parent = t.parent.data();
+    int* dist = t.dist.data();
+    auto run = [&](size_t count, size_t grain, auto&& f) {
+        if (pool) {
+            parallel_for(*pool, 0, count, f, grain);
+        } else {
+            f(0, count);
+        }
+    };
+
+    std::vector<int> queue(n), next_queue(n);
+    std::vector<unsigned long long> front(words), next(words);
+    size_t size = 1, last_size = 0; // 当前层和上一层的节点数
+    queue[0] = s;
+    parent[s] = s;
+    dist[s] = 0;
+    long long scout = out.degree(s); // 当前层的出边数
+    long long unexplored = out.edge_size(); // 未访问节点的出边数
+    bool bottom_up = false;
+    for (int level = 0; size > 0; ++level) {
+        unexplored -= scout;
+        if (!bottom_up && scout > unexplored / BFS_ALPHA) {
+            std::fill(front.begin(), front.end(), 0);
+            for (size_t i = 0; i < size; ++i) {
+                front[queue[i] >> 6] |= 1ULL << (queue[i] & 63);
+            }
+            bottom_up = true;
+        } else if (bottom_up && size < last_size && size < (size_t)n / BFS_BETA) {
+            size = 0;
+            for (size_t w = 0; w < words; ++w) {
+                for (unsigned long long bits = front[w]; bits; bits &= bits - 1) {
+                    queue[size++] = w * 64 + __builtin_ctzll(bits);
+                }
+            }
+            bottom_up = false;
+        }
+
+        std::atomic<size_t> found(0);
+        std::atomic<long long> found_edges(0);
+        if (bottom_up) {
+            run(words, 16, [&](size_t lo, size_t hi) {
+                size_t local = 0;
+                long long edges = 0;
+                for (size_t w = lo; w < hi; ++w) {
+                    unsigned long long bits = 0;
+                    const int last = std::min<long long>(n, (w + 1) * 64);
+                    for (int v = w * 64; v < last; ++v) {
+                        if (parent[v] >= 0) {
+                            continue;
+                        }
+                        for (int k = in.offset[v]; k < in.offset[v + 1]; ++k) {
+                            const int u = in.to[k];
+                            if (front[u >> 6] >> (u & 63) & 1) {
+                                parent[v] = u;
+                                dist[v] = level + 1;
+                                bits |= 1ULL << (v & 63);
+                                ++local;
+                                edges += out.degree(v);
+                                break;
+                            }
+                        }
+                    }
+                    next[w] = bits;
+                }
+                found += local;
+                found_edges += edges;
+            });
+            front.swap(next);
+        } else {
+            run(size, 256, [&](size_t lo, size_t hi) {
+                std::vector<int> local;
+                long long edges = 0;
+                for (size_t i = lo; i < hi; ++i) {
+                    const int u = queue[i];
+                    for (int k = out.offset[u]; k < out.offset[u + 1]; ++k) {
+                        const int v = out.to[k];
+                        if (__atomic_load_n(&parent[v], __ATOMIC_RELAXED) < 0
+                            && __sync_bool_compare_and_swap(&parent[v], -1, u)) {
+                            dist[v] = level + 1;
+                            local.push_back(v);
+                            edges += out.degree(v);
+                        }
+                    }
+                }
+                const size_t pos = found.fetch_add(local.size());
+                std::copy(local.begin(), local.end(), next_queue.begin() + pos);
+                found_edges += edges;
+            });
+            queue.swap(next_queue);
+        }
+        last_size = size;
+        size = found;
+        scout = found_edges;
+    }
+    return t;
+}
+
+/**
+ * @brief 多线程方向优化BFS
+ */
+inline bfs_tree_t bfs_tree(const csr_t& out, const csr_t& in, int s, ThreadPool& pool)
+{
+    return bfs_tree(out, in, s, &pool);
+}
+
+/**
+ * @brief 无向图(每条边都有反向边)的方向优化BFS，入边与出边相同
+ */
+inline bfs_tree_t bfs_tree(const csr_t& g, int s, ThreadPool* pool = nullptr)
+{
+    return bfs_tree(g, g, s, pool);
+}
+
+inline bfs_tree_t bfs_tree(const csr_t& g, int s, ThreadPool& pool)
+{
+    return bfs_tree(g, g, s, &pool);
+}
+} // namespace degraph
+
+#endif // MY_DEGRAPH_BFS_HPP
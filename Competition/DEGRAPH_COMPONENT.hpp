@@ -0,0 +1,223 @@
+#ifndef MY_DEGRAPH_COMPONENT_HPP
+#define MY_DEGRAPH_COMPONENT_HPP
+/**
+ * @brief 连通分量
+ *
+ * @brief 无锁并查集 union_find_t (CAS合并 + 路径减半，可以多线程同时调用find/unite)
+ * @brief 多线程连通分量 connected_components (Afforest)
+ * @brief 增量模式：union_find_t提供add_edge(u, v)，可以直接作为degen::graph_sink等接收边的对象
+ *
+ * @note 合并时总是把编号大的根接到编号小的根上，不会成环，每个分量的代表元为其中最小的节点编号
+ * @note Afforest：先只用每个节点的前两条边合并，此时最大的分量已经基本成形；
+ *       抽样找出最大的分量后，跳过其中的节点，只处理剩下节点的其余边，大部分边不需要访问
+ *
+ * @example 使用示例
+ * int main()
+ * {
+ *     ThreadPool pool(8);
+ *     degraph::csr_t g = ...; // 无向图
+ *     std::vector<int> comp = degraph::connected_components(g, pool);
+ *
+ *     degraph::union_find_t uf(5);
+ *     uf.add_edge(0, 1), uf.add_edge(3, 4);
+ *     int c = uf.count(); // 3
+ *     bool same = uf.same(0, 1); // true
+ *     return 0;
+ * }
+ */
+
+#include "../MultiThread/ThreadPool.hpp"
+#include "DEGRAPH.hpp"
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <vector>
+
+namespace degraph {
+struct union_find_t {
+    std::vector<int> parent; // 根节点的parent为自己
+    std::atomic<int> components; // 分量的个数
+
+    union_find_t(int n = 0)
+        : parent(n)
+        , components(n)
+    {
+        std::iota(parent.begin(), parent.end(), 0);
+    }
+
+    int vertex_size() const
+    {
+        return parent.size();
+    }
+
+    void expand(int i) // 确保节点i存在，不能与其他操作同时调用
+    {
+        while ((int)parent.size() <= i) {
+            parent.push_back(parent.size());
+            ++components;
+        }
+    }
+
+    /**
+     * @brief 求x所在分量的根
+     * @note 路径减半：每一步用CAS把x的父节点改为祖父节点，失败说明其他线程已经改过，直接继续
+     */
+    int find(int x)
+    {
+        for (;;) {
+            const int p = __atomic_load_n(&parent[x], __ATOMIC_RELAXED);
+            const int g = __atomic_load_n(&parent[p], __ATOMIC_RELAXED);
+            if (p == g) {
+                return p;
+            }
+            int expected = p;
+            __atomic_compare_exchange_n(&parent[x], &expected, g, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+            x = g;
+        }
+    }
+
+    /**
+     * @brief 合并a和b所在的分量
+     * @return a和b原来是否在不同的分量中
+     */
+    bool unite(int a, int b)
+    {
+        for (;;) {
+            a = find(a), b = find(b);
+            if (a == b) {
+                return false;
+            }
+            if (a < b) {
+                std::swap(a, b);
+            }
+            // a的根可能已被其他线程接到别处，CAS失败时重新查找
+            int expected = a;
+            if (__atomic_compare_exchange_n(&parent[a], &expected, b, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+                --components;
+                return true;
+            }
+        }
+    }
+
+    bool same(int a, int b)
+    {
+        return find(a) == find(b);
+    }
+
+    int count() const // 分量的个数
+    {
+        return components;
+    }
+
+    /**
+     * @brief 增量加边，节点不存在时自动扩展(扩展不是线程安全的)
+     */
+    void add_edge(int u, int v)
+    {
+        expand(std::max(u, v));
+        unite(u, v);
+    }
+
+    /**
+     * @brief 让每个节点直接指向根，之后parent[v]即为分量的代表元
+     */
+    void compress(ThreadPool* pool = nullptr)
+    {
+        auto f = [&](size_t lo, size_t hi) {
+            for (size_t v = lo; v < hi; ++v) {
+                __atomic_store_n(&parent[v], find(v), __ATOMIC_RELAXED);
+            }
+        };
+        if (pool) {
+            parallel_for(*pool, 0, parent.size(), f, 4096);
+        } else {
+            f(0, parent.size());
+        }
+    }
+};
+
+constexpr int AFFOREST_ROUNDS = 2; // 第一阶段使用每个节点的前几条边
+constexpr int AFFOREST_SAMPLES = 1024; // 抽样找最大分量的次数
+
+/**
+ * @brief Afforest连通分量
+ * @param g 图；symmetric为true时要求每条边都有反向边
+ * @param symmetric 为false时按弱连通处理，不能跳过最大分量中的节点，会访问所有边
+ * @param pool 线程池，为nullptr时在当前线程计算
+ * @return comp[v]为v所在分量中最小的节点编号
+ */
+inline std::vector<int> connected_components(const csr_t& g, bool symmetric, ThreadPool* pool)
+{
+    const int n = g.vertex_size();
+    union_find_t uf(n);
+    auto run = [&](auto&& f) {
+        if (pool) {
+            parallel_for(*pool, 0, n, f, 4096);
+        } else {
+            f(0, n);
+        }
+    };
+    for (int r = 0; r < AFFOREST_ROUNDS; ++r) {
+        run([&](size_t lo, size_t hi) {
+            for (size_t v = lo; v < hi; ++v) {
+                if (g.offset[v] + r < g.offset[v + 1]) {
+                    uf.unite(v, g.to[g.offset[v] + r]);
+                }
+            }
+        });
+        uf.compress(pool);
+    }
+
+    // 抽样求出现最多的代表元
+    int largest = -1;
+    if (symmetric && n > 0) {
+        std::vector<int> samples(AFFOREST_SAMPLES);
+        unsigned long long x = 0x9e3779b97f4a7c15ULL;
+        for (int& s : samples) {
+            x ^= x << 13, x ^= x >> 7, x ^= x << 17;
+            s = uf.parent[x % n];
+        }
+        std::sort(samples.begin(), samples.end());
+        int most = 0;
+        for (int i = 0, j = 0; i < AFFOREST_SAMPLES; i = j) {
+            while (j < AFFOREST_SAMPLES && samples[j] == samples[i]) {
+                ++j;
+            }
+            if (j - i > most) {
+                most = j - i, largest = samples[i];
+            }
+        }
+    }
+
+    run([&](size_t lo, size_t hi) {
+        for (size_t v = lo; v < hi; ++v) {
+            if (symmetric && uf.find(v) == largest) {
+                continue; // 最大分量中的节点的边，另一端也会处理到
+            }
+            for (int k = g.offset[v] + AFFOREST_ROUNDS; k < g.offset[v + 1]; ++k) {
+                uf.unite(v, g.to[k]);
+            }
+        }
+    });
+    uf.compress(pool);
+    return std::move(uf.parent);
+}
+
+/**
+ * @brief 多线程连通分量
+ */
+inline std::vector<int> connected_components(const csr_t& g, ThreadPool& pool, bool symmetric = true)
+{
+    return connected_components(g, symmetric, &pool);
+}
+
+/**
+ * @brief 单线程连通分量
+ */
+inline std::vector<int> connected_components(const csr_t& g, bool symmetric = true)
+{
+    return connected_components(g, symmetric, nullptr);
+}
+} // namespace degraph
+
+#endif // MY_DEGRAPH_COMPONENT_HPP
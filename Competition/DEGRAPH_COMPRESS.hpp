@@ -0,0 +1,249 @@
+#ifndef MY_DEGRAPH_COMPRESS_HPP
+#define MY_DEGRAPH_COMPRESS_HPP
+/**
+ * @brief 压缩的只读邻接表
+ *
+ * @brief compressed_csr_t：每个节点的出边排序后存差分，差分用变长整数(varint)按字节编码
+ * @brief 遍历 for_each(u, f) 与 neighbors(u) (前向迭代器，边解码边遍历)
+ *
+ * @note 第一个邻居存与u的差(zigzag编码，可以为负)，之后存与前一个邻居的差；
+ *       每字节低7位为数据，最高位为1表示后面还有字节，差小于128时只占1字节
+ * @note 每个节点另外需要12字节(字节偏移8 + 边偏移4)；graph_t每条边8字节，
+ *       度数较大且邻居编号相近(如经过rcm_order/community_order重排)的图通常可以压缩到1/3 ~ 1/4
+ * @note 边编号e为边在压缩后顺序中的位置(0 ~ edge_size() - 1)；构造时keep_ids为true则保留原边编号，每条边多4字节
+ * @note 提供vertex_size()、edge_size()、degree()和for_each(u, f)，可以直接用于bfs、topological_sort等只需要for_each的算法
+ *
+ * @example 使用示例
+ * int main()
+ * {
+ *     degraph::csr_t csr = ...;
+ *     degraph::compressed_csr_t g(csr);
+ *     std::vector<int> d = degraph::bfs(g, 0);
+ *     for (int v : g.neighbors(0)) {
+ *         debug::cerr() << v << "\n";
+ *     }
+ *     size_t bytes = g.memory_size();
+ *     return 0;
+ * }
+ */
+
+#include "DEGRAPH.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace degraph {
+/**
+ * @brief 压缩的只读有向图
+ */
+struct compressed_csr_t {
+    std::vector<uint64_t> offset; // offset[u]为u的编码在data中的起始字节，共vertex_size() + 1个
+    std::vector<int> edge_offset; // edge_offset[u]为u的第一条出边的位置
+    std::vector<uint8_t> data; // 所有节点的varint编码
+    std::vector<int> id; // 原边编号，构造时keep_ids为false则为空
+
+    /**
+     * @brief 解码u的邻居的前向迭代器
+     */
+    struct iterator {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = int;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const int*;
+        using reference = int;
+
+        const uint8_t* p;
+        int remain; // 还未解码的邻居数(包括当前)
+        int value;
+
+        iterator(const uint8_t* p, int remain, int u)
+            : p(p)
+            , remain(remain)
+            , value(u)
+        {
+            if (remain > 0) {
+                value = u + unzigzag(read_varint(this->p));
+            }
+        }
+
+        int operator*() const
+        {
+            return value;
+        }
+
+        iterator& operator++()
+        {
+            if (--remain > 0) {
+                value += read_varint(p);
+            }
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            iterator it = *this;
+            ++*this;
+            return it;
+        }
+
+        bool operator==(const iterator& other) const
+        {
+            return remain == other.remain;
+        }
+
+        bool operator!=(const iterator& other) const
+        {
+            return remain != other.remain;
+        }
+    };
+
+    struct range_t {
+        iterator first, last;
+        iterator begin() const
+        {
+            return first;
+        }
+        iterator end() const
+        {
+            return last;
+        }
+    };
+
+    compressed_csr_t()
+        : offset(1, 0)
+        , edge_offset(1, 0)
+    {
+    }
+
+    /**
+     * @brief 从CSR构建，每个节点的出边按指向的节点编号排序后编码(重边保留)
+     * @param keep_ids 是否保留原边编号
+     */
+    explicit compressed_csr_t(const csr_t& g, bool keep_ids = false)
+    {
+        const int n = g.vertex_size();
+        offset.assign(n + 1, 0);
+        edge_offset.assign(g.offset.begin(), g.offset.end());
+        data.reserve(g.edge_size() + n);
+        if (keep_ids) {
+            id.resize(g.edge_size());
+        }
+        std::vector<std::pair<int, int>> edges;
+        for (int u = 0; u < n; ++u) {
+            edges.clear();
+            for (int k = g.offset[u]; k < g.offset[u + 1]; ++k) {
+                edges.emplace_back(g.to[k], g.id[k]);
+            }
+            std::sort(edges.begin(), edges.end());
+            int last = u;
+            for (size_t i = 0; i < edges.size(); ++i) {
+                const int v = edges[i].first;
+                if (i == 0) {
+                    write_varint(zigzag(v - u));
+                } else {
+                    write_varint(v - last);
+                }
+                last = v;
+                if (keep_ids) {
+                    id[g.offset[u] + i] = edges[i].second;
+                }
+            }
+            offset[u + 1] = data.size();
+        }
+        data.shrink_to_fit();
+    }
+
+    /**
+     * @brief 从任意提供vertex_size()和for_each(u, f)的图构建
+     */
+    template <typename Graph>
+    explicit compressed_csr_t(const Graph& g, bool keep_ids = false)
+        : compressed_csr_t(csr_t(g), keep_ids)
+    {
+    }
+
+    int edge_size() const // 返回边的数量
+    {
+        return edge_offset.back();
+    }
+
+    int vertex_size() const // 返回节点的数量
+    {
+        return offset.size() - 1;
+    }
+
+    int degree(int u) const // 返回u的出度
+    {
+        return edge_offset[u + 1] - edge_offset[u];
+    }
+
+    range_t neighbors(int u) const // u的邻居，按编号从小到大
+    {
+        return { iterator(data.data() + offset[u], degree(u), u), iterator(nullptr, 0, 0) };
+    }
+
+    template <typename F>
+    void for_each(int u, F&& f) const // 对u的每条出边调用f(v, e)，按v从小到大
+    {
+        const int first = edge_offset[u], last = edge_offset[u + 1];
+        if (first == last) {
+            return;
+        }
+        const uint8_t* p = data.data() + offset[u];
+        int v = u + unzigzag(read_varint(p));
+        f(v, id.empty() ? first : id[first]);
+        for (int k = first + 1; k < last; ++k) {
+            v += read_varint(p);
+            f(v, id.empty() ? k : id[k]);
+        }
+    }
+
+    size_t memory_size() const // 占用的字节数
+    {
+        return offset.capacity() * sizeof(uint64_t) + edge_offset.capacity() * sizeof(int) + data.capacity() + id.capacity() * sizeof(int);
+    }
+
+    /**
+     * @brief 读取一个varint，p移到下一个varint的开头
+     */
+    static uint64_t read_varint(const uint8_t*& p)
+    {
+        uint64_t x = *p++;
+        if (x < 0x80) {
+            return x;
+        }
+        x &= 0x7f;
+        for (int shift = 7;; shift += 7) {
+            const uint64_t b = *p++;
+            x |= (b & 0x7f) << shift;
+            if (b < 0x80) {
+                return x;
+            }
+        }
+    }
+
+    static uint64_t zigzag(int64_t x) // 把有符号数映射为无符号数：0, -1, 1, -2 ... -> 0, 1, 2, 3 ...
+    {
+        return ((uint64_t)x << 1) ^ (uint64_t)(x >> 63);
+    }
+
+    static int unzigzag(uint64_t z)
+    {
+        return (int)(z >> 1) ^ -(int)(z & 1);
+    }
+
+private:
+    void write_varint(uint64_t x)
+    {
+        while (x >= 0x80) {
+            data.push_back((uint8_t)(x | 0x80));
+            x >>= 7;
+        }
+        data.push_back((uint8_t)x);
+    }
+};
+} // namespace degraph
+
+#endif // MY_DEGRAPH_COMPRESS_HPP
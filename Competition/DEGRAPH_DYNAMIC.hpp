@@ -0,0 +1,309 @@
+#ifndef MY_DEGRAPH_DYNAMIC_HPP
+#define MY_DEGRAPH_DYNAMIC_HPP
+/**
+ * @brief 支持频繁加边删边的动态有向图
+ *
+ * @brief 加边 add_edge，按端点删边 delete_edge，按编号删边 erase，查边 find_edge，均为期望O(1)
+ * @brief 遍历 for_each(u, f)，与graph_t相同，可以直接用于bfs等算法和freeze()
+ *
+ * @note 每个节点的出边组成双向链表，删除时直接从链表中摘下，不需要遍历邻接表
+ * @note (u, v) -> 最后添加的边编号 存在开放寻址哈希表中，重边通过same链接起来
+ * @note 删除的边留下墓碑，墓碑数超过存活边数时自动压缩，均摊O(1)
+ *       压缩会重新编号，已删除边之后的边编号会改变；需要保存边编号时把auto_compact设为false，再手动调用compact()
+ *
+ * @example 使用示例
+ * int main()
+ * {
+ *     degraph::dynamic_graph_t g;
+ *     int e = g.add_edge(0, 1);
+ *     g.add_edge(1, 2);
+ *     g.delete_edge(1, 2);
+ *     g.erase(e);
+ *     bool has = g.has_edge(0, 1); // false
+ *     degraph::csr_t csr = g.freeze();
+ *     return 0;
+ * }
+ */
+
+#include "DEGRAPH.hpp"
+#include <vector>
+
+namespace degraph {
+/**
+ * @brief 64位键到int的开放寻址哈希表(线性探测)
+ * @note 删除时把后面的元素前移(backward shift)，表中没有墓碑，探测长度不会随删除增长
+ */
+struct edge_table_t {
+    static constexpr unsigned long long EMPTY = ~0ULL;
+    std::vector<unsigned long long> keys;
+    std::vector<int> values;
+    int count = 0;
+
+    static unsigned long long key(int u, int v)
+    {
+        return (unsigned long long)(unsigned)u << 32 | (unsigned)v;
+    }
+
+    size_t slot(unsigned long long k) const
+    {
+        k ^= k >> 33;
+        k *= 0xff51afd7ed558ccdULL;
+        k ^= k >> 33;
+        return k & (keys.size() - 1);
+    }
+
+    int find(unsigned long long k) const // 返回k对应的值，不存在时返回-1
+    {
+        if (keys.empty()) {
+            return -1;
+        }
+        for (size_t i = slot(k);; i = (i + 1) & (keys.size() - 1)) {
+            if (keys[i] == k) {
+                return values[i];
+            }
+            if (keys[i] == EMPTY) {
+                return -1;
+            }
+        }
+    }
+
+    void set(unsigned long long k, int value)
+    {
+        if ((count + 1) * 2 > (int)keys.size()) {
+            rehash(keys.empty() ? 16 : keys.size() * 2);
+        }
+        size_t i = slot(k);
+        for (; keys[i] != EMPTY; i = (i + 1) & (keys.size() - 1)) {
+            if (keys[i] == k) {
+                values[i] = value;
+                return;
+            }
+        }
+        keys[i] = k;
+        values[i] = value;
+        ++count;
+    }
+
+    void erase(unsigned long long k)
+    {
+        if (keys.empty()) {
+            return;
+        }
+        const size_t mask = keys.size() - 1;
+        size_t i = slot(k);
+        for (; keys[i] != k; i = (i + 1) & mask) {
+            if (keys[i] == EMPTY) {
+                return;
+            }
+        }
+        // 把后面探测链上的元素前移到空位，只移动那些理想位置不在(i, j]之间的元素
+        for (size_t j = (i + 1) & mask; keys[j] != EMPTY; j = (j + 1) & mask) {
+            const size_t home = slot(keys[j]);
+            if (((j - home) & mask) >= ((j - i) & mask)) {
+                keys[i] = keys[j];
+                values[i] = values[j];
+                i = j;
+            }
+        }
+        keys[i] = EMPTY;
+        --count;
+    }
+
+    void rehash(size_t capacity)
+    {
+        std::vector<unsigned long long> old_keys(capacity, EMPTY);
+        std::vector<int> old_values(capacity);
+        old_keys.swap(keys);
+        old_values.swap(values);
+        count = 0;
+        for (size_t i = 0; i < old_keys.size(); ++i) {
+            if (old_keys[i] != EMPTY) {
+                set(old_keys[i], old_values[i]);
+            }
+        }
+    }
+
+    void clear()
+    {
+        keys.clear();
+        values.clear();
+        count = 0;
+    }
+};
+
+struct dynamic_graph_t;
+std::true_type is_linked_list(const dynamic_graph_t*); // 邻接表也是头插法，csr_t构建时恢复成添加的顺序
+
+struct dynamic_graph_t {
+    std::vector<int> info; // info[i]记录i节点最后一条边的编号，没有出边时为-1
+    std::vector<int> next; // 链表中下一条(更早添加的)边
+    std::vector<int> prev; // 链表中上一条(更晚添加的)边，链表头为-1
+    std::vector<int> from; // from[e]为边e的起点，已删除的边为-1
+    std::vector<int> to; // to[e]为边e的终点
+    std::vector<int> same; // 端点相同的上一条存活的边，没有为-1
+    edge_table_t table; // (u, v) -> 端点为(u, v)的最后一条存活的边
+    int alive = 0; // 存活的边数
+    bool auto_compact = true; // 墓碑过多时是否自动压缩
+
+    /**
+     * @brief Construct a new dynamic_graph_t object
+     * @param n 节点数量
+     * @param m 边数量
+     */
+    dynamic_graph_t(int n = 0, int m = 0)
+        : info(n, -1)
+    {
+        next.reserve(m), prev.reserve(m), from.reserve(m), to.reserve(m), same.reserve(m);
+    }
+
+    int edge_size() const // 返回存活的边数
+    {
+        return alive;
+    }
+
+    int vertex_size() const // 返回节点的数量(最大节点编号+1)
+    {
+        return info.size();
+    }
+
+    void expand(int i) // 确保info数组的大小至少为i+1(扩展图的节点数量)
+    {
+        if ((int)info.size() <= i) {
+            info.resize(i + 1, -1);
+        }
+    }
+
+    int add_edge(int i, int j) // 添加从i到j的边，返回边的编号
+    {
+        expand(i), expand(j);
+        const int e = to.size();
+        const unsigned long long k = edge_table_t::key(i, j);
+        from.push_back(i);
+        to.push_back(j);
+        next.push_back(info[i]);
+        prev.push_back(-1);
+        same.push_back(table.find(k));
+        if (info[i] >= 0) {
+            prev[info[i]] = e;
+        }
+        info[i] = e;
+        table.set(k, e);
+        ++alive;
+        return e;
+    }
+
+    int find_edge(int i, int j) const // 返回从i到j的最后添加的边，不存在时返回-1
+    {
+        return table.find(edge_table_t::key(i, j));
+    }
+
+    bool has_edge(int i, int j) const
+    {
+        return find_edge(i, j) >= 0;
+    }
+
+    void erase(int e) // 删除编号为e的边
+    {
+        if (e < 0 || e >= (int)from.size() || from[e] < 0) {
+            return;
+        }
+        const int u = from[e];
+        if (prev[e] >= 0) {
+            next[prev[e]] = next[e];
+        } else {
+            info[u] = next[e];
+        }
+        if (next[e] >= 0) {
+            prev[next[e]] = prev[e];
+        }
+        const unsigned long long k = edge_table_t::key(u, to[e]);
+        int x = table.find(k);
+        if (x == e) {
+            if (same[e] >= 0) {
+                table.set(k, same[e]);
+            } else {
+                table.erase(k);
+            }
+        } else {
+            // e不是最后添加的重边，只有重边时才会走到这里
+            while (same[x] != e) {
+                x = same[x];
+            }
+            same[x] = same[e];
+        }
+        from[e] = -1;
+        --alive;
+        if (auto_compact && dead() > alive && dead() >= 1024) {
+            compact();
+        }
+    }
+
+    void delete_edge(int i, int j) // 删除从i到j的边(最后添加的边)
+    {
+        erase(find_edge(i, j));
+    }
+
+    int dead() const // 墓碑的数量
+    {
+        return (int)from.size() - alive;
+    }
+
+    /**
+     * @brief 清除墓碑，存活的边按原来的顺序重新编号为0..alive-1
+     * @note 时间复杂度O(边数 + 哈希表大小)
+     */
+    void compact()
+    {
+        std::vector<int> id(from.size(), -1);
+        int m = 0;
+        for (int e = 0; e < (int)from.size(); ++e) {
+            if (from[e] >= 0) {
+                id[e] = m;
+                from[m] = from[e];
+                to[m] = to[e];
+                same[m] = same[e] >= 0 ? id[same[e]] : -1; // same[e] < e，已经重新编号
+                ++m;
+            }
+        }
+        from.resize(m), to.resize(m), same.resize(m), next.resize(m), prev.resize(m);
+        // 按编号从小到大重新头插，链表顺序不变
+        std::fill(info.begin(), info.end(), -1);
+        for (int e = 0; e < m; ++e) {
+            next[e] = info[from[e]];
+            prev[e] = -1;
+            if (info[from[e]] >= 0) {
+                prev[info[from[e]]] = e;
+            }
+            info[from[e]] = e;
+        }
+        for (size_t i = 0; i < table.keys.size(); ++i) {
+            if (table.keys[i] != edge_table_t::EMPTY) {
+                table.values[i] = id[table.values[i]];
+            }
+        }
+    }
+
+    template <typename F>
+    void for_each(int u, F&& f) const // 对u的每条出边调用f(v, e)，按添加顺序的逆序
+    {
+        for (int k = info[u]; k >= 0; k = next[k]) {
+            f(to[k], k);
+        }
+    }
+
+    csr_t freeze(bool sorted = false) const // 生成CSR快照
+    {
+        return csr_t(*this, sorted);
+    }
+
+    void clear()
+    {
+        info.clear();
+        next.clear(), prev.clear(), from.clear(), to.clear(), same.clear();
+        table.clear();
+        alive = 0;
+    }
+};
+} // namespace degraph
+
+#endif // MY_DEGRAPH_DYNAMIC_HPP
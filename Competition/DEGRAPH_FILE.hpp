@@ -0,0 +1,384 @@
+#ifndef MY_DEGRAPH_FILE_HPP
+#define MY_DEGRAPH_FILE_HPP
+/**
+ * @brief 二进制CSR图文件，用mmap只读打开，不需要解析
+ *
+ * @brief 写文件 graph_writer_t (CSR拓扑 + 任意个按CSR顺序排列的属性列)
+ * @brief 读文件 mapped_graph_t (mmap映射，offset/to/id和属性列直接指向映射的内存)
+ *
+ * @note 文件格式(小端序)：
+ *       file_header_t | file_section_t * sections | 对齐到64字节的各段数据
+ *       段"offset"、"to"、"id"为CSR拓扑(int32)，其余段为属性列，每段记录元素大小和校验和
+ * @note 打开时只校验文件头和段表，段的数据在第一次访问时才由操作系统读入(按页懒加载)，
+ *       打开10^9条边的图只需要一次mmap；需要完整校验时调用verify()，会读入整个文件
+ * @note 只支持POSIX系统(mmap)
+ *
+ * @example 使用示例
+ * int main()
+ * {
+ *     degraph::weighted_graph_t<float> g(3, 2);
+ *     g.add_edge(0, 1, 1.5f), g.add_edge(1, 2, 2.5f);
+ *     degraph::csr_t csr = g.freeze();
+ *     degraph::graph_writer_t writer(csr);
+ *     writer.add_column("weight", g.gather<0>(csr));
+ *     writer.write("graph.bin");
+ *
+ *     degraph::mapped_graph_t m;
+ *     if (m.open("graph.bin")) {
+ *         const float* w = m.column<float>("weight");
+ *         std::vector<int> d = degraph::bfs(m, 0);
+ *     }
+ *     return 0;
+ * }
+ */
+
+#include "DEGRAPH.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <limits>
+#include <memory>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+#include <vector>
+
+namespace degraph {
+constexpr char FILE_MAGIC[8] = { 'D', 'E', 'G', 'R', 'A', 'P', 'H', '\0' };
+constexpr uint32_t FILE_VERSION = 1;
+constexpr uint64_t FILE_ALIGN = 64; // 每段数据的起始位置对齐到64字节
+
+struct file_header_t {
+    char magic[8];
+    uint32_t version;
+    uint32_t sections; // 段的数量
+    uint64_t vertices; // 节点数
+    uint64_t edges; // 边数
+    uint64_t checksum; // 文件头(checksum为0)和段表的校验和
+};
+
+struct file_section_t {
+    char name[32]; // 段名，以'\0'结尾
+    uint64_t offset; // 数据在文件中的位置
+    uint64_t bytes; // 数据的字节数
+    uint64_t elem_size; // 每个元素的字节数
+    uint64_t checksum; // 数据的校验和
+};
+
+/**
+ * @brief 64位校验和，每次处理8字节
+ * @note 不是密码学哈希，只用于发现截断和损坏的文件
+ */
+inline uint64_t file_checksum(const void* data, size_t bytes, uint64_t h = 0x9e3779b97f4a7c15ULL)
+{
+    const unsigned char* p = (const unsigned char*)data;
+    for (; bytes >= 8; bytes -= 8, p += 8) {
+        uint64_t w;
+        memcpy(&w, p, 8);
+        h = (h ^ w) * 0xff51afd7ed558ccdULL;
+        h ^= h >> 29;
+    }
+    uint64_t w = 0;
+    memcpy(&w, p, bytes);
+    h = (h ^ w ^ bytes) * 0xc4ceb9fe1a85ec53ULL;
+    return h ^ (h >> 32);
+}
+
+/**
+ * @brief 将CSR快照和属性列写入二进制文件
+ * @note 属性列必须按CSR中边的顺序排列(可以用basic_graph_t::gather得到)，元素类型必须可以按字节复制
+ */
+struct graph_writer_t {
+    struct column_t {
+        std::string name;
+        const void* data;
+        uint64_t bytes;
+        uint64_t elem_size;
+    };
+    const csr_t& csr;
+    std::vector<column_t> columns;
+    std::vector<std::shared_ptr<void>> owned; // 以右值传入的属性列
+
+    graph_writer_t(const csr_t& csr)
+        : csr(csr)
+    {
+        add_column("offset", csr.offset);
+        add_column("to", csr.to);
+        add_column("id", csr.id);
+    }
+
+    /**
+     * @brief 添加一个属性列，写入前column必须一直有效
+     */
+    template <typename T>
+    void add_column(const std::string& name, const std::vector<T>& column)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "add_column: column type must be trivially copyable");
+        columns.push_back({ name.substr(0, sizeof(file_section_t::name) - 1), column.data(), column.size() * sizeof(T), sizeof(T) });
+    }
+
+    /**
+     * @brief 添加一个临时的属性列，由graph_writer_t保管
+     */
+    template <typename T>
+    void add_column(const std::string& name, std::vector<T>&& column)
+    {
+        auto p = std::make_shared<std::vector<T>>(std::move(column));
+        owned.push_back(p);
+        add_column(name, *p);
+    }
+
+    /**
+     * @brief 写入文件
+     * @return 是否成功
+     */
+    bool write(const char* path) const
+    {
+        file_header_t header = {};
+        memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+        header.version = FILE_VERSION;
+        header.sections = columns.size();
+        header.vertices = csr.vertex_size();
+        header.edges = csr.edge_size();
+        std::vector<file_section_t> table(columns.size());
+        uint64_t pos = sizeof(file_header_t) + sizeof(file_section_t) * table.size();
+        for (size_t i = 0; i < columns.size(); ++i) {
+            pos = (pos + FILE_ALIGN - 1) / FILE_ALIGN * FILE_ALIGN;
+            memset(&table[i], 0, sizeof(file_section_t));
+            memcpy(table[i].name, columns[i].name.c_str(), columns[i].name.size());
+            table[i].offset = pos;
+            table[i].bytes = columns[i].bytes;
+            table[i].elem_size = columns[i].elem_size;
+            table[i].checksum = file_checksum(columns[i].data, columns[i].bytes);
+            pos += columns[i].bytes;
+        }
+        header.checksum = file_checksum(table.data(), sizeof(file_section_t) * table.size(), file_checksum(&header, sizeof(header)));
+
+        FILE* f = fopen(path, "wb");
+        if (!f) {
+            return false;
+        }
+        bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+        ok = ok && fwrite(table.data(), sizeof(file_section_t), table.size(), f) == table.size();
+        static const char zeros[FILE_ALIGN] = {};
+        pos = sizeof(file_header_t) + sizeof(file_section_t) * table.size();
+        for (size_t i = 0; i < columns.size() && ok; ++i) {
+            ok = fwrite(zeros, 1, table[i].offset - pos, f) == table[i].offset - pos;
+            ok = ok && fwrite(columns[i].data, 1, columns[i].bytes, f) == columns[i].bytes;
+            pos = table[i].offset + table[i].bytes;
+        }
+        return fclose(f) == 0 && ok;
+    }
+};
+
+/**
+ * @brief 用mmap只读映射的整个文件
+ * @note 不可复制，析构时解除映射
+ */
+struct mapped_file_t {
+    void* base = nullptr;
+    size_t length = 0;
+
+    mapped_file_t() = default;
+    mapped_file_t(const mapped_file_t&) = delete;
+    mapped_file_t& operator=(const mapped_file_t&) = delete;
+    ~mapped_file_t()
+    {
+        close();
+    }
+
+    /**
+     * @brief 映射文件，失败时返回false
+     * @note 空文件不映射，返回true，data()为nullptr，size()为0
+     */
+    bool open(const char* path)
+    {
+        close();
+        const int fd = ::open(path, O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
+        }
+        if (st.st_size == 0) {
+            ::close(fd);
+            return true;
+        }
+        length = st.st_size;
+        base = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd); // 映射建立后可以关闭文件描述符
+        if (base == MAP_FAILED) {
+            base = nullptr;
+            length = 0;
+            return false;
+        }
+        return true;
+    }
+
+    void close()
+    {
+        if (base) {
+            munmap(base, length);
+        }
+        base = nullptr;
+        length = 0;
+    }
+
+    const char* data() const
+    {
+        return (const char*)base;
+    }
+
+    size_t size() const
+    {
+        return length;
+    }
+};
+
+/**
+ * @brief 用mmap只读打开的CSR图
+ * @note 提供与csr_t相同的vertex_size()、edge_size()、degree()和for_each(u, f)，可以直接用于bfs等算法
+ * @note 不可复制，析构时解除映射
+ */
+struct mapped_graph_t {
+    const int* offset = nullptr;
+    const int* to = nullptr;
+    const int* id = nullptr;
+    const file_header_t* header = nullptr;
+    const file_section_t* table = nullptr;
+    mapped_file_t file;
+
+    /**
+     * @brief 打开文件，校验文件头、段表和拓扑段的大小
+     * @return 是否成功，失败时不持有任何资源
+     */
+    bool open(const char* path)
+    {
+        close();
+        if (!file.open(path) || file.size() < sizeof(file_header_t) || !check()) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close()
+    {
+        file.close();
+        header = nullptr, table = nullptr;
+        offset = to = id = nullptr;
+    }
+
+    /**
+     * @brief 按名称查找段，不存在时返回nullptr
+     */
+    const file_section_t* section(const char* name) const
+    {
+        for (uint32_t i = 0; header && i < header->sections; ++i) {
+            if (strncmp(table[i].name, name, sizeof(table[i].name)) == 0) {
+                return &table[i];
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief 按名称取属性列，不存在或元素大小不符时返回nullptr
+     * @note 只返回指针，数据在第一次读取时才按页载入
+     */
+    template <typename T>
+    const T* column(const char* name) const
+    {
+        const file_section_t* s = section(name);
+        if (!s || s->elem_size != sizeof(T)) {
+            return nullptr;
+        }
+        return (const T*)(file.data() + s->offset);
+    }
+
+    /**
+     * @brief 校验所有段的数据，会读入整个文件
+     */
+    bool verify() const
+    {
+        for (uint32_t i = 0; header && i < header->sections; ++i) {
+            if (file_checksum(file.data() + table[i].offset, table[i].bytes) != table[i].checksum) {
+                return false;
+            }
+        }
+        return header != nullptr;
+    }
+
+    int vertex_size() const
+    {
+        return header ? header->vertices : 0;
+    }
+
+    int edge_size() const
+    {
+        return header ? header->edges : 0;
+    }
+
+    int degree(int u) const
+    {
+        return offset[u + 1] - offset[u];
+    }
+
+    template <typename F>
+    void for_each(int u, F&& f) const // 对u的每条出边调用f(v, e)
+    {
+        for (int k = offset[u]; k < offset[u + 1]; ++k) {
+            f(to[k], id[k]);
+        }
+    }
+
+private:
+    bool check()
+    {
+        const size_t length = file.size();
+        header = (const file_header_t*)file.data();
+        if (memcmp(header->magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 || header->version != FILE_VERSION) {
+            return false;
+        }
+        const uint64_t table_bytes = sizeof(file_section_t) * (uint64_t)header->sections;
+        if (sizeof(file_header_t) + table_bytes > length) {
+            return false;
+        }
+        table = (const file_section_t*)(header + 1);
+        file_header_t h = *header;
+        h.checksum = 0;
+        if (file_checksum(table, table_bytes, file_checksum(&h, sizeof(h))) != header->checksum) {
+            return false;
+        }
+        for (uint32_t i = 0; i < header->sections; ++i) {
+            // 分开比较，offset + bytes可能溢出
+            if (table[i].offset % FILE_ALIGN != 0 || table[i].offset > length || table[i].bytes > length - table[i].offset) {
+                return false;
+            }
+        }
+        // 节点数和边数必须能用int表示，段的大小用除法比较，避免count * sizeof(int)溢出
+        if (header->vertices >= (uint64_t)std::numeric_limits<int>::max() || header->edges > (uint64_t)std::numeric_limits<int>::max()) {
+            return false;
+        }
+        auto topology = [&](const char* name, uint64_t count) {
+            const file_section_t* s = section(name);
+            return s && s->elem_size == sizeof(int) && s->bytes % sizeof(int) == 0 && s->bytes / sizeof(int) == count;
+        };
+        if (!topology("offset", header->vertices + 1) || !topology("to", header->edges) || !topology("id", header->edges)) {
+            return false;
+        }
+        offset = column<int>("offset");
+        to = column<int>("to");
+        id = column<int>("id");
+        return true;
+    }
+};
+} // namespace degraph
+
+#endif // MY_DEGRAPH_FILE_HPP
@@ -0,0 +1,390 @@
+#ifndef MY_DEGRAPH_FLOW_HPP
+#define MY_DEGRAPH_FLOW_HPP
+/**
+ * @brief 最大流与最小割
+ *
+ * @brief 流网络 flow_graph_t (边e与反向边e^1成对存放)
+ * @brief Dinic dinic_t (当前弧优化，迭代增广)
+ * @brief 最高标号预流推进 push_relabel_t (gap优化 + 全局重标号)
+ * @brief 最小割 min_cut
+ *
+ * @note flow_graph_t的边属性为(残量, 容量)两列，add_arc总是连续添加一对边，所以e^1为e的反向边
+ * @note dinic_t和push_relabel_t是可复用的求解上下文，只在节点数变大时重新分配内存，适合反复求解大量小规模的流
+ * @note 两种算法都在当前残量上继续增广，返回本次增加的流量；重新求解前调用reset()
+ *       Dinic适合单位容量图和二分图匹配(O(m sqrt(n)))，预流推进适合稠密图和容量差别大的图
+ *
+ * @example 使用示例
+ * int main()
+ * {
+ *     degraph::flow_graph_t<int> g(4, 10); // 4个节点，预留5对边
+ *     g.add_arc(0, 1, 3), g.add_arc(0, 2, 2), g.add_arc(1, 2, 1);
+ *     int e = g.add_arc(1, 3, 2);
+ *     g.add_arc(2, 3, 3);
+ *     int f = degraph::dinic(g, 0, 3); // 5
+ *     int fe = g.flow(e); // 边1->3上的流量
+ *     std::vector<char> side = degraph::min_cut(g, 0); // side[v]为1表示v在源点一侧
+ *
+ *     g.reset();
+ *     degraph::push_relabel_t<int> pr;
+ *     f = pr.max_flow(g, 0, 3); // 5
+ *     return 0;
+ * }
+ */
+
+#include "DEGRAPH.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace degraph {
+/**
+ * @brief 流网络
+ * @param C 容量类型，整数或浮点数
+ * @note 用add_arc添加边，不要直接调用add_edge，否则e^1不再是反向边
+ */
+template <typename C>
+struct flow_graph_t : basic_graph_t<edge_props<C, C>> {
+    using basic_graph_t<edge_props<C, C>>::basic_graph_t;
+
+    std::vector<C>& residual() // residual()[e]为边e的残量
+    {
+        return this->template edge<0>();
+    }
+    const std::vector<C>& residual() const
+    {
+        return this->template edge<0>();
+    }
+    std::vector<C>& capacity() // capacity()[e]为边e的容量
+    {
+        return this->template edge<1>();
+    }
+    const std::vector<C>& capacity() const
+    {
+        return this->template edge<1>();
+    }
+
+    /**
+     * @brief 添加从u到v、容量为cap的边，同时添加容量为reverse_cap的反向边
+     * @return 正向边的编号e(偶数)，反向边为e^1；无向边的reverse_cap取cap
+     */
+    int add_arc(int u, int v, C cap, C reverse_cap = 0)
+    {
+#ifdef GXY_DEBUG
+        if (this->to.size() % 2 != 0) {
+            debug::cerr() << "flow_graph_t::add_arc: edges must be added in pairs\n";
+            throw std::runtime_error("flow_graph_t::add_arc: edges must be added in pairs");
+        }
+#endif
+        const int e = this->add_edge(u, v, cap, cap);
+        this->add_edge(v, u, reverse_cap, reverse_cap);
+        return e;
+    }
+
+    C flow(int e) const // 边e上的流量，反向边上为负
+    {
+        return capacity()[e] - residual()[e];
+    }
+
+    void reset() // 清空所有流量
+    {
+        residual() = capacity();
+    }
+};
+
+/**
+ * @brief Dinic最大流的求解上下文
+ * @note BFS分层后用当前弧cur[u]做迭代DFS，路径上的边放在显式栈中，不会因为路径过长爆栈
+ *       时间复杂度O(n^2 m)，单位容量图O(m sqrt(n))
+ */
+template <typename C>
+struct dinic_t {
+    std::vector<int> level; // 到源点的层数，-1为不可达
+    std::vector<int> cur; // 当前弧
+    std::vector<int> queue;
+    std::vector<int> path; // 从源点开始的增广路径上的边
+
+    /**
+     * @brief 在g的当前残量上增广到最大流
+     * @return 增加的流量，s == t时为0
+     */
+    C max_flow(flow_graph_t<C>& g, int s, int t)
+    {
+        if (s == t) {
+            return 0;
+        }
+        const int n = g.vertex_size();
+        if ((int)level.size() < n) {
+            level.resize(n);
+            cur.resize(n);
+            queue.resize(n);
+            path.reserve(n);
+        }
+        C total = 0;
+        while (bfs(g, s, t)) {
+            std::copy(g.info.begin(), g.info.end(), cur.begin());
+            total += augment(g, s, t);
+        }
+        return total;
+    }
+
+private:
+    bool bfs(const flow_graph_t<C>& g, int s, int t)
+    {
+        const std::vector<C>& res = g.residual();
+        std::fill(level.begin(), level.begin() + g.vertex_size(), -1);
+        int head = 0, tail = 0;
+        queue[tail++] = s;
+        level[s] = 0;
+        while (head < tail && level[t] < 0) {
+            const int u = queue[head++];
+            for (int e = g.info[u]; e >= 0; e = g.next[e]) {
+                const int v = g.to[e];
+                if (res[e] > 0 && level[v] < 0) {
+                    level[v] = level[u] + 1;
+                    queue[tail++] = v;
+                }
+            }
+        }
+        return level[t] >= 0;
+    }
+
+    C augment(flow_graph_t<C>& g, int s, int t) // 求一个阻塞流
+    {
+        std::vector<C>& res = g.residual();
+        C total = 0;
+        path.clear();
+        int u = s;
+        for (;;) {
+            if (u == t) {
+                C d = res[path[0]];
+                for (int e : path) {
+                    d = std::min(d, res[e]);
+                }
+                size_t first = path.size();
+                for (size_t i = 0; i < path.size(); ++i) {
+                    res[path[i]] -= d;
+                    res[path[i] ^ 1] += d;
+                    if (first == path.size() && res[path[i]] == 0) {
+                        first = i;
+                    }
+                }
+                total += d;
+                // 退回到第一条饱和边的起点，之前的边仍可继续使用
+                path.resize(first);
+                u = first == 0 ? s : g.to[path[first - 1]];
+                continue;
+            }
+            int& e = cur[u];
+            while (e >= 0 && (res[e] <= 0 || level[g.to[e]] != level[u] + 1)) {
+                e = g.next[e];
+            }
+            if (e >= 0) {
+                path.push_back(e);
+                u = g.to[e];
+                continue;
+            }
+            // u无法到达汇点，从分层图中删去，退回上一个节点并跳过这条边
+            level[u] = -1;
+            if (path.empty()) {
+                break;
+            }
+            const int back = path.back();
+            path.pop_back();
+            u = g.to[back ^ 1];
+            cur[u] = g.next[cur[u]];
+        }
+        return total;
+    }
+};
+
+/**
+ * @brief 最高标号预流推进的求解上下文
+ * @note 每次取高度最高的活跃节点推流，高度不超过2n，最后多余的流会退回源点，结果是合法的流
+ *       gap优化：某个高度(< n)上没有节点时，高于它的节点都无法到达汇点，直接抬高到n + 1
+ *       全局重标号：每进行n次重标号，从汇点(和源点)在残量网络上反向BFS，把高度设为准确的距离
+ *       时间复杂度O(n^2 sqrt(m))
+ */
+template <typename C>
+struct push_relabel_t {
+    std::vector<int> height;
+    std::vector<C> excess;
+    std::vector<int> cur; // 当前弧
+    std::vector<int> count; // count[h]为高度为h的节点数
+    std::vector<std::vector<int>> active; // active[h]为高度为h的活跃节点
+    std::vector<int> queue;
+
+    /**
+     * @brief 在g的当前残量上增广到最大流
+     * @return 增加的流量，s == t时为0
+     */
+    C max_flow(flow_graph_t<C>& g, int s, int t)
+    {
+        if (s == t) {
+            return 0;
+        }
+        const int n = g.vertex_size();
+        std::vector<C>& res = g.residual();
+        if ((int)height.size() < n) {
+            height.resize(n);
+            excess.resize(n);
+            cur.resize(n);
+            queue.resize(n);
+        }
+        count.assign(2 * n + 1, 0);
+        active.resize(2 * n + 1);
+        std::fill(excess.begin(), excess.begin() + n, 0);
+        for (int e = g.info[s]; e >= 0; e = g.next[e]) {
+            const C d = res[e];
+            res[e] -= d, res[e ^ 1] += d;
+            excess[s] -= d, excess[g.to[e]] += d;
+        }
+        int hi = global_relabel(g, s, t), relabels = 0;
+        for (;;) {
+            while (hi >= 0 && active[hi].empty()) {
+                --hi;
+            }
+            if (hi < 0) {
+                break;
+            }
+            const int u = active[hi].back();
+            active[hi].pop_back();
+            // 推空u的超额流
+            while (excess[u] > 0) {
+                int& e = cur[u];
+                if (e >= 0) {
+                    const int v = g.to[e];
+                    if (res[e] > 0 && height[u] == height[v] + 1) {
+                        const C d = std::min(excess[u], res[e]);
+                        if (excess[v] == 0 && v != s && v != t) {
+                            active[height[v]].push_back(v);
+                        }
+                        res[e] -= d, res[e ^ 1] += d;
+                        excess[u] -= d, excess[v] += d;
+                    } else {
+                        e = g.next[e];
+                    }
+                    continue;
+                }
+                // 重标号
+                const int old = height[u];
+                int h = 2 * n;
+                for (int k = g.info[u]; k >= 0; k = g.next[k]) {
+                    if (res[k] > 0 && height[g.to[k]] + 1 < h) {
+                        h = height[g.to[k]] + 1;
+                        e = k;
+                    }
+                }
+                --count[old], ++count[h];
+                height[u] = h;
+                if (count[old] == 0 && old < n) {
+                    for (int v = 0; v < n; ++v) {
+                        if (height[v] > old && height[v] < n) {
+                            --count[height[v]], ++count[n + 1];
+                            height[v] = n + 1;
+                            cur[v] = g.info[v];
+                        }
+                    }
+                }
+                hi = height[u];
+                if (++relabels >= n) {
+                    relabels = 0;
+                    hi = global_relabel(g, s, t);
+                    break;
+                }
+            }
+        }
+        return excess[t];
+    }
+
+private:
+    /**
+     * @brief 全局重标号，重建count和active
+     * @return 活跃节点的最高高度
+     * @note 能到达汇点的节点高度为到汇点的距离，其余能到达源点的节点为n + 到源点的距离
+     */
+    int global_relabel(const flow_graph_t<C>& g, int s, int t)
+    {
+        const int n = g.vertex_size();
+        const std::vector<C>& res = g.residual();
+        std::fill(height.begin(), height.begin() + n, 2 * n);
+        auto bfs = [&](int root, int base) {
+            int head = 0, tail = 0;
+            queue[tail++] = root;
+            height[root] = base;
+            while (head < tail) {
+                const int v = queue[head++];
+                for (int e = g.info[v]; e >= 0; e = g.next[e]) {
+                    const int u = g.to[e];
+                    if (res[e ^ 1] > 0 && height[u] == 2 * n) {
+                        height[u] = height[v] + 1;
+                        queue[tail++] = u;
+                    }
+                }
+            }
+        };
+        bfs(t, 0);
+        if (height[s] == 2 * n) {
+            bfs(s, n);
+        }
+        height[s] = n;
+        std::fill(count.begin(), count.end(), 0);
+        for (auto& a : active) {
+            a.clear();
+        }
+        int hi = -1;
+        for (int v = 0; v < n; ++v) {
+            ++count[height[v]];
+            cur[v] = g.info[v];
+            if (excess[v] > 0 && v != s && v != t) {
+                active[height[v]].push_back(v);
+                hi = std::max(hi, height[v]);
+            }
+        }
+        return hi;
+    }
+};
+
+/**
+ * @brief 单次求解的Dinic最大流
+ */
+template <typename C>
+C dinic(flow_graph_t<C>& g, int s, int t)
+{
+    return dinic_t<C>().max_flow(g, s, t);
+}
+
+/**
+ * @brief 单次求解的最高标号预流推进最大流
+ */
+template <typename C>
+C push_relabel(flow_graph_t<C>& g, int s, int t)
+{
+    return push_relabel_t<C>().max_flow(g, s, t);
+}
+
+/**
+ * @brief 求出最大流后的最小割
+ * @return side[v]为1表示v在残量网络上可以从s到达(源点一侧)；
+ *         起点在源点一侧、终点不在的正向边(偶数编号)组成最小割
+ */
+template <typename C>
+std::vector<char> min_cut(const flow_graph_t<C>& g, int s)
+{
+    const std::vector<C>& res = g.residual();
+    std::vector<char> side(g.vertex_size(), 0);
+    std::vector<int> queue = { s };
+    side[s] = 1;
+    for (size_t head = 0; head < queue.size(); ++head) {
+        const int u = queue[head];
+        for (int e = g.info[u]; e >= 0; e = g.next[e]) {
+            if (res[e] > 0 && !side[g.to[e]]) {
+                side[g.to[e]] = 1;
+                queue.push_back(g.to[e]);
+            }
+        }
+    }
+    return side;
+}
+} // namespace degraph
+
+#endif // MY_DEGRAPH_FLOW_HPP
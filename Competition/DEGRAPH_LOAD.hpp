@@ -0,0 +1,327 @@
+#ifndef MY_DEGRAPH_LOAD_HPP
+#define MY_DEGRAPH_LOAD_HPP
+/**
+ * @brief 多线程批量建图
+ *
+ * @brief 从边数组建图 build_csr, build_graph
+ * @brief 从边表文件建图 load_edge_list (文本每行"u v"，或二进制int32对)
+ *
+ * @note 一次多线程流程：文件用mmap映射后按行边界切成若干块并行解析，
+ *       每块统计自己的出度直方图，前缀和得到每块每个节点的写入位置，再并行把边直接散布到CSR中，
+ *       不需要逐条add_edge，也没有原子操作；每个节点的出边保持文件中的顺序
+ * @note 直方图需要 块数 * 节点数 个int，节点数远多于边数时改为原子计数，散布后再按边编号排序，结果相同
+ * @note 文本格式中以'#'或'%'开头的行为注释，每行只读取前两个整数，后面的内容(如权值)被忽略
+ *
+ * @example 使用示例
+ * int main()
+ * {
+ *     ThreadPool pool(8);
+ *     degraph::csr_t csr;
+ *     if (!degraph::load_edge_list("edges.txt", csr, pool, 1)) { // 文件中的节点编号从1开始
+ *         return 1;
+ *     }
+ *     degraph::graph_t g;
+ *     degraph::load_edge_list("edges.bin", g, pool, 0, true); // 二进制文件直接建成邻接表
+ *     return 0;
+ * }
+ */
+
+#include "../MultiThread/ThreadPool.hpp"
+#include "DEGRAPH.hpp"
+#include "DEGRAPH_FILE.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace degraph {
+/**
+ * @brief 一段连续的边，第i条边为from[i] -> to[i]
+ */
+struct edge_span_t {
+    const int* from;
+    const int* to;
+    size_t size;
+};
+
+/**
+ * @brief 从分块的边数组建CSR
+ * @param blocks 各块的边，边编号按块的顺序依次排列
+ * @param n 节点数，所有节点编号必须小于n
+ * @note 每块一个任务；CSR中每个节点的出边按边编号从小到大排列
+ */
+inline csr_t build_csr(const std::vector<edge_span_t>& blocks, int n, ThreadPool& pool)
+{
+    const size_t b = blocks.size();
+    std::vector<size_t> start(b + 1, 0); // 每块第一条边的编号
+    for (size_t i = 0; i < b; ++i) {
+        start[i + 1] = start[i] + blocks[i].size;
+    }
+    const size_t m = start[b];
+    csr_t csr;
+    csr.offset.assign(n + 1, 0);
+    csr.to.resize(m);
+    csr.id.resize(m);
+    int* offset = csr.offset.data();
+
+    if (b * (n + 1) <= 2 * m + n) {
+        // 每块一个出度直方图，hist[i][u]变为块i中u的第一条边的写入位置
+        std::vector<std::vector<int>> hist(b);
+        parallel_for(pool, 0, b, [&](size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; ++i) {
+                hist[i].assign(n, 0);
+                for (size_t k = 0; k < blocks[i].size; ++k) {
+                    ++hist[i][blocks[i].from[k]];
+                }
+            }
+        }, 1);
+        parallel_for(pool, 0, n, [&](size_t lo, size_t hi) {
+            for (size_t u = lo; u < hi; ++u) {
+                int d = 0;
+                for (size_t i = 0; i < b; ++i) {
+                    d += hist[i][u];
+                }
+                offset[u + 1] = d;
+            }
+        }, 4096);
+        for (int u = 0; u < n; ++u) {
+            offset[u + 1] += offset[u];
+        }
+        parallel_for(pool, 0, n, [&](size_t lo, size_t hi) {
+            for (size_t u = lo; u < hi; ++u) {
+                int pos = offset[u];
+                for (size_t i = 0; i < b; ++i) {
+                    const int d = hist[i][u];
+                    hist[i][u] = pos;
+                    pos += d;
+                }
+            }
+        }, 4096);
+        parallel_for(pool, 0, b, [&](size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; ++i) {
+                int* cursor = hist[i].data();
+                for (size_t k = 0; k < blocks[i].size; ++k) {
+                    const int p = cursor[blocks[i].from[k]]++;
+                    csr.to[p] = blocks[i].to[k];
+                    csr.id[p] = start[i] + k;
+                }
+            }
+        }, 1);
+        return csr;
+    }
+
+    // 节点数太多时用原子计数，散布后每个节点的出边顺序不确定，按边编号排序
+    parallel_for(pool, 0, b, [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            for (size_t k = 0; k < blocks[i].size; ++k) {
+                __atomic_fetch_add(&offset[blocks[i].from[k] + 1], 1, __ATOMIC_RELAXED);
+            }
+        }
+    }, 1);
+    for (int u = 0; u < n; ++u) {
+        offset[u + 1] += offset[u];
+    }
+    std::vector<int> cursor(csr.offset.begin(), csr.offset.end() - 1);
+    parallel_for(pool, 0, b, [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            for (size_t k = 0; k < blocks[i].size; ++k) {
+                const int p = __atomic_fetch_add(&cursor[blocks[i].from[k]], 1, __ATOMIC_RELAXED);
+                csr.to[p] = blocks[i].to[k];
+                csr.id[p] = start[i] + k;
+            }
+        }
+    }, 1);
+    parallel_for(pool, 0, n, [&](size_t lo, size_t hi) {
+        std::vector<std::pair<int, int>> edges;
+        for (size_t u = lo; u < hi; ++u) {
+            const int first = offset[u], last = offset[u + 1];
+            if (last - first < 2) {
+                continue;
+            }
+            edges.clear();
+            for (int k = first; k < last; ++k) {
+                edges.emplace_back(csr.id[k], csr.to[k]);
+            }
+            std::sort(edges.begin(), edges.end());
+            for (int k = first; k < last; ++k) {
+                csr.id[k] = edges[k - first].first;
+                csr.to[k] = edges[k - first].second;
+            }
+        }
+    }, 1024);
+    return csr;
+}
+
+/**
+ * @brief 从边数组建CSR，第i条边为from[i] -> to[i]
+ * @param n 节点数，为-1时取最大节点编号+1
+ */
+inline csr_t build_csr(const std::vector<int>& from, const std::vector<int>& to, ThreadPool& pool, int n = -1)
+{
+    const size_t m = from.size(), b = std::max<size_t>(1, pool.size());
+    if (n < 0) {
+        n = 0;
+        for (size_t i = 0; i < m; ++i) {
+            n = std::max(n, std::max(from[i], to[i]) + 1);
+        }
+    }
+    std::vector<edge_span_t> blocks;
+    for (size_t i = 0; i < b; ++i) {
+        const size_t lo = m * i / b, hi = m * (i + 1) / b;
+        blocks.push_back({ from.data() + lo, to.data() + lo, hi - lo });
+    }
+    return build_csr(blocks, n, pool);
+}
+
+/**
+ * @brief 由CSR填充graph_t的info/next/to，边编号与CSR的id相同
+ * @note 要求每个节点的出边按边编号从小到大排列(build_csr的结果满足)，之后for_each的顺序与逐条add_edge相同
+ */
+inline void build_graph(const csr_t& csr, graph_t& g, ThreadPool& pool)
+{
+    const int n = csr.vertex_size();
+    g.info.assign(n, -1);
+    g.next.resize(csr.edge_size());
+    g.to.resize(csr.edge_size());
+    parallel_for(pool, 0, n, [&](size_t lo, size_t hi) {
+        for (size_t u = lo; u < hi; ++u) {
+            int last = -1;
+            for (int k = csr.offset[u]; k < csr.offset[u + 1]; ++k) {
+                const int e = csr.id[k];
+                g.to[e] = csr.to[k];
+                g.next[e] = last;
+                last = e;
+            }
+            g.info[u] = last;
+        }
+    }, 4096);
+}
+
+/**
+ * @brief 解析文本边表[first, last)，每行的前两个整数为一条边
+ * @param base 文件中节点编号的起点，读入后减去base
+ * @return 最大节点编号
+ */
+inline int parse_edge_text(const char* first, const char* last, int base, std::vector<int>& from, std::vector<int>& to)
+{
+    int max_id = -1;
+    const char* p = first;
+    while (p < last) {
+        if (*p == '#' || *p == '%') {
+            while (p < last && *p != '\n') {
+                ++p;
+            }
+            continue;
+        }
+        int x[2], count = 0;
+        while (p < last && *p != '\n' && count < 2) {
+            if (*p >= '0' && *p <= '9') {
+                int v = 0;
+                while (p < last && *p >= '0' && *p <= '9') {
+                    v = v * 10 + (*p++ - '0');
+                }
+                x[count++] = v - base;
+            } else {
+                ++p;
+            }
+        }
+        while (p < last && *p != '\n') {
+            ++p;
+        }
+        ++p;
+        if (count == 2) {
+#ifdef GXY_DEBUG
+            if (x[0] < 0 || x[1] < 0) {
+                debug::cerr() << "parse_edge_text: vertex id is less than base\n";
+                throw std::runtime_error("parse_edge_text: vertex id is less than base");
+            }
+#endif
+            from.push_back(x[0]);
+            to.push_back(x[1]);
+            max_id = std::max(max_id, std::max(x[0], x[1]));
+        }
+    }
+    return max_id;
+}
+
+/**
+ * @brief 多线程读取边表文件建CSR
+ * @param path 文件路径
+ * @param base 文件中节点编号的起点
+ * @param binary 为true时文件为连续的(int32 u, int32 v)对，否则为文本
+ * @param n 节点数，为-1时取最大节点编号+1
+ * @return 是否成功打开文件；空文件得到没有边的图(n为-1时节点数为0)
+ */
+inline bool load_edge_list(const char* path, csr_t& csr, ThreadPool& pool, int base = 0, bool binary = false, int n = -1)
+{
+    mapped_file_t file;
+    if (!file.open(path)) {
+        return false;
+    }
+    const char* data = file.data();
+    const size_t size = file.size();
+    const size_t b = std::max<size_t>(1, pool.size() * 4);
+    std::vector<size_t> cut(b + 1);
+    for (size_t i = 0; i <= b; ++i) {
+        cut[i] = size * i / b;
+        if (binary) {
+            cut[i] -= cut[i] % (2 * sizeof(int));
+        } else if (i > 0 && i < b) {
+            // 切分点移到下一行的开头
+            cut[i] = std::max(cut[i], cut[i - 1]);
+            while (cut[i] > 0 && cut[i] < size && data[cut[i] - 1] != '\n') {
+                ++cut[i];
+            }
+        }
+    }
+    cut[b] = binary ? size - size % (2 * sizeof(int)) : size;
+
+    std::vector<std::vector<int>> from(b), to(b);
+    std::vector<int> max_id(b, -1);
+    parallel_for(pool, 0, b, [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            if (binary) {
+                const size_t count = (cut[i + 1] - cut[i]) / (2 * sizeof(int));
+                from[i].resize(count);
+                to[i].resize(count);
+                for (size_t k = 0; k < count; ++k) {
+                    int x[2];
+                    memcpy(x, data + cut[i] + k * sizeof(x), sizeof(x));
+                    from[i][k] = x[0] - base;
+                    to[i][k] = x[1] - base;
+                    max_id[i] = std::max(max_id[i], std::max(from[i][k], to[i][k]));
+                }
+            } else {
+                from[i].reserve((cut[i + 1] - cut[i]) / 8);
+                to[i].reserve((cut[i + 1] - cut[i]) / 8);
+                max_id[i] = parse_edge_text(data + cut[i], data + cut[i + 1], base, from[i], to[i]);
+            }
+        }
+    }, 1);
+
+    if (n < 0) {
+        n = *std::max_element(max_id.begin(), max_id.end()) + 1;
+    }
+    std::vector<edge_span_t> blocks(b);
+    for (size_t i = 0; i < b; ++i) {
+        blocks[i] = { from[i].data(), to[i].data(), from[i].size() };
+    }
+    csr = build_csr(blocks, n, pool);
+    return true;
+}
+
+/**
+ * @brief 多线程读取边表文件，直接建成graph_t的邻接表
+ */
+inline bool load_edge_list(const char* path, graph_t& g, ThreadPool& pool, int base = 0, bool binary = false, int n = -1)
+{
+    csr_t csr;
+    if (!load_edge_list(path, csr, pool, base, binary, n)) {
+        return false;
+    }
+    build_graph(csr, g, pool);
+    return true;
+}
+} // namespace degraph
+
+#endif // MY_DEGRAPH_LOAD_HPP
@@ -0,0 +1,376 @@
+#ifndef MY_DEGRAPH_PATH_HPP
+#define MY_DEGRAPH_PATH_HPP
+/**
+ * @brief 带权图的单源最短路，边权非负
+ *
+ * @brief 可复用的查询上下文 shortest_path_t，dijkstra(g, s, target)
+ *        整数边权使用基数堆(radix heap)，浮点边权使用4叉索引堆
+ * @brief 多线程delta-stepping delta_stepping(g, s, delta, pool)
+ *
+ * @note shortest_path_t只在构造时按节点数分配一次内存，每次查询结束后只重置被访问过的节点，
+ *       反复查询时不重新分配，也不需要O(n)的初始化
+ * @note 基数堆利用Dijkstra取出的键单调不减：按与上次取出的键的最高不同位分桶，
+ *       每个元素至多在桶之间移动O(log C)次，取最小值不需要比较
+ *
+ * @example 使用示例
+ * int main()
+ * {
+ *     degraph::weighted_graph_t<int> g(4, 4);
+ *     g.add_edge(0, 1, 5), g.add_edge(0, 2, 1), g.add_edge(2, 1, 2), g.add_edge(1, 3, 1);
+ *     degraph::weighted_csr_t<int> csr = g.freeze();
+ *     degraph::shortest_path_t<int> sp(csr.vertex_size());
+ *     sp.dijkstra(csr, 0); // sp.dist = { 0, 3, 1, 4 }
+ *     std::vector<int> path = sp.path(3); // { 0, 2, 1, 3 }
+ *     sp.dijkstra(csr, 2, 3); // 到达3后提前结束
+ *
+ *     ThreadPool pool(8);
+ *     std::vector<int> d = degraph::delta_stepping(csr, 0, 4, pool);
+ *     return 0;
+ * }
+ */
+
+#include "../MultiThread/ThreadPool.hpp"
+#include "DEGRAPH.hpp"
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace degraph {
+/**
+ * @brief 单源最短路的查询上下文
+ * @param W 边权类型，整数或浮点数
+ * @note 查询结果在dist和parent中，直到下一次查询；不可达的节点dist为INF，parent为-1
+ */
+template <typename W>
+struct shortest_path_t {
+    static constexpr W INF = std::numeric_limits<W>::max();
+    static constexpr bool RADIX = std::is_integral_v<W>;
+    using key_t = std::make_unsigned_t<std::conditional_t<RADIX, W, int>>;
+    static constexpr int BITS = sizeof(key_t) * 8;
+
+    std::vector<W> dist;
+    std::vector<int> parent;
+    std::vector<int> visited; // 本次查询中dist被修改过的节点
+
+    // 基数堆，bucket[b]中的键与last的最高不同位为b - 1，bucket[0]中的键等于last
+    std::vector<std::pair<key_t, int>> bucket[BITS + 1];
+    key_t last;
+    size_t heap_size;
+
+    // 4叉索引堆，heap中存放节点，pos[v]为v在heap中的位置，不在堆中为-1
+    std::vector<int> heap;
+    std::vector<int> pos;
+
+    shortest_path_t(int n = 0)
+    {
+        resize(n);
+    }
+
+    void resize(int n)
+    {
+        dist.assign(n, INF);
+        parent.assign(n, -1);
+        visited.clear();
+        visited.reserve(n);
+        if constexpr (!RADIX) {
+            heap.reserve(n);
+            pos.assign(n, -1);
+        }
+    }
+
+    /**
+     * @brief 从s出发的Dijkstra
+     * @param target 不为-1时，target的距离确定后立即结束，其他节点的dist可能不是最短距离
+     */
+    void dijkstra(const weighted_csr_t<W>& g, int s, int target = -1)
+    {
+        if ((int)dist.size() != g.vertex_size()) {
+            resize(g.vertex_size());
+        }
+        reset();
+        relax(s, 0, -1);
+        while (!empty()) {
+            const int u = pop();
+            if (u < 0) {
+                continue; // 基数堆中过期的元素
+            }
+            if (u == target) {
+                break;
+            }
+            const W du = dist[u];
+            for (int k = g.offset[u]; k < g.offset[u + 1]; ++k) {
+                const int v = g.to[k];
+                const W dv = du + g.weight[k];
+                if (dv < dist[v]) {
+                    relax(v, dv, u);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief 上一次查询中从源点到t的路径，不可达时为空
+     */
+    std::vector<int> path(int t) const
+    {
+        std::vector<int> p;
+        if (dist[t] == INF) {
+            return p;
+        }
+        for (int v = t; v >= 0; v = parent[v]) {
+            p.push_back(v);
+        }
+        std::reverse(p.begin(), p.end());
+        return p;
+    }
+
+    /**
+     * @brief 只重置上一次查询访问过的节点，时间复杂度O(访问过的节点数)
+     */
+    void reset()
+    {
+        for (int v : visited) {
+            dist[v] = INF;
+            parent[v] = -1;
+        }
+        visited.clear();
+        if constexpr (RADIX) {
+            for (auto& b : bucket) {
+                b.clear();
+            }
+            last = 0;
+            heap_size = 0;
+        } else {
+            for (int v : heap) {
+                pos[v] = -1;
+            }
+            heap.clear();
+        }
+    }
+
+private:
+    void relax(int v, W d, int p)
+    {
+        if (dist[v] == INF) {
+            visited.push_back(v);
+        }
+        dist[v] = d;
+        parent[v] = p;
+        if constexpr (RADIX) {
+            push_radix(d, v);
+        } else {
+            if (pos[v] < 0) {
+                pos[v] = heap.size();
+                heap.push_back(v);
+            }
+            sift_up(pos[v]);
+        }
+    }
+
+    bool empty() const
+    {
+        if constexpr (RADIX) {
+            return heap_size == 0;
+        } else {
+            return heap.empty();
+        }
+    }
+
+    /**
+     * @brief 取出距离最小的节点，基数堆中的过期元素返回-1
+     */
+    int pop()
+    {
+        if constexpr (RADIX) {
+            if (bucket[0].empty()) {
+                int b = 1;
+                while (bucket[b].empty()) {
+                    ++b;
+                }
+                // 新的last为桶b中的最小键，桶b中的元素与新last的最高不同位都低于b - 1
+                key_t m = bucket[b][0].first;
+                for (auto& e : bucket[b]) {
+                    m = std::min(m, e.first);
+                }
+                last = m;
+                for (auto& e : bucket[b]) {
+                    bucket[index(e.first)].push_back(e);
+                }
+                bucket[b].clear();
+            }
+            const std::pair<key_t, int> e = bucket[0].back();
+            bucket[0].pop_back();
+            --heap_size;
+            return (key_t)dist[e.second] == e.first ? e.second : -1;
+        } else {
+            const int u = heap[0];
+            pos[u] = -1;
+            const int v = heap.back();
+            heap.pop_back();
+            if (!heap.empty()) {
+                heap[0] = v;
+                pos[v] = 0;
+                sift_down(0);
+            }
+            return u;
+        }
+    }
+
+    int index(key_t k) const
+    {
+        return k == last ? 0 : 64 - __builtin_clzll((unsigned long long)(k ^ last));
+    }
+
+    void push_radix(W d, int v)
+    {
+        bucket[index(d)].emplace_back(d, v);
+        ++heap_size;
+    }
+
+    void sift_up(int i)
+    {
+        const int v = heap[i];
+        while (i > 0) {
+            const int p = (i - 1) / 4;
+            if (dist[heap[p]] <= dist[v]) {
+                break;
+            }
+            heap[i] = heap[p];
+            pos[heap[i]] = i;
+            i = p;
+        }
+        heap[i] = v;
+        pos[v] = i;
+    }
+
+    void sift_down(int i)
+    {
+        const int v = heap[i], n = heap.size();
+        for (;;) {
+            const int first = 4 * i + 1;
+            if (first >= n) {
+                break;
+            }
+            int best = first;
+            for (int c = first + 1; c < first + 4 && c < n; ++c) {
+                if (dist[heap[c]] < dist[heap[best]]) {
+                    best = c;
+                }
+            }
+            if (dist[heap[best]] >= dist[v]) {
+                break;
+            }
+            heap[i] = heap[best];
+            pos[heap[i]] = i;
+            i = best;
+        }
+        heap[i] = v;
+        pos[v] = i;
+    }
+};
+
+/**
+ * @brief 单次查询的Dijkstra
+ * @return 每个节点到s的距离，不可达为numeric_limits<W>::max()
+ */
+template <typename W>
+std::vector<W> dijkstra(const weighted_csr_t<W>& g, int s)
+{
+    shortest_path_t<W> sp(g.vertex_size());
+    sp.dijkstra(g, s);
+    return std::move(sp.dist);
+}
+
+/**
+ * @brief 多线程delta-stepping单源最短路
+ * @param delta 桶的宽度，通常取平均边权附近的值；delta越小越接近Dijkstra，越大并行度越高但重复松弛越多，必须为正数
+ * @return 每个节点到s的距离，不可达为numeric_limits<W>::max()
+ * @note 距离在[i * delta, (i + 1) * delta)中的节点放在第i个桶中，每次并行处理编号最小的非空桶
+ *       每个任务槽有自己的桶数组，松弛用CAS取最小值，桶中可能有过期的重复元素，处理时跳过
+ * @note 非空的桶只可能在[current, current + 最大边权 / delta + 1]中，桶数组循环使用，每个槽只需要最大边权 / delta + 2个桶
+ */
+template <typename W>
+std::vector<W> delta_stepping(const weighted_csr_t<W>& g, int s, W delta, ThreadPool& pool)
+{
+#ifdef GXY_DEBUG
+    if (!(delta > 0)) {
+        debug::cerr() << "delta_stepping: delta must be positive\n";
+        throw std::runtime_error("delta_stepping: delta must be positive");
+    }
+#endif
+    constexpr W INF = std::numeric_limits<W>::max();
+    const int n = g.vertex_size();
+    std::vector<std::atomic<W>> dist(n);
+    for (auto& d : dist) {
+        d.store(INF, std::memory_order_relaxed);
+    }
+    const size_t slots = std::max<size_t>(1, pool.size() * 4);
+    W max_weight = 0;
+    for (const W& w : g.weight) {
+        max_weight = std::max(max_weight, w);
+    }
+    const size_t size = (size_t)(max_weight / delta) + 2;
+    // bins[slot][i % size]为槽slot的第i个桶
+    std::vector<std::vector<std::vector<int>>> bins(slots, std::vector<std::vector<int>>(size));
+    std::vector<int> frontier = { s };
+    dist[s] = 0;
+    size_t current = 0;
+    while (!frontier.empty()) {
+        parallel_for(pool, 0, slots, [&](size_t lo, size_t hi) {
+            for (size_t slot = lo; slot < hi; ++slot) {
+                auto& local = bins[slot];
+                const size_t first = frontier.size() * slot / slots, last = frontier.size() * (slot + 1) / slots;
+                for (size_t i = first; i < last; ++i) {
+                    const int u = frontier[i];
+                    const W du = dist[u].load(std::memory_order_relaxed);
+                    if (du / delta < (W)current) {
+                        continue; // 已经在更早的桶中处理过
+                    }
+                    for (int k = g.offset[u]; k < g.offset[u + 1]; ++k) {
+                        const int v = g.to[k];
+                        const W dv = du + g.weight[k];
+                        W old = dist[v].load(std::memory_order_relaxed);
+                        while (dv < old) {
+                            if (dist[v].compare_exchange_weak(old, dv, std::memory_order_relaxed)) {
+                                local[(size_t)(dv / delta) % size].push_back(v);
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+        }, frontier.size() < 1024 ? slots : 1); // 桶很小时直接在当前线程处理，避免直径大的图上每轮都要调度线程池
+        // 找到编号最小的非空桶，合并所有槽中的这个桶作为新的frontier
+        size_t next = std::numeric_limits<size_t>::max();
+        for (auto& local : bins) {
+            for (size_t b = current; b < current + size && b < next; ++b) {
+                if (!local[b % size].empty()) {
+                    next = b;
+                    break;
+                }
+            }
+        }
+        frontier.clear();
+        if (next == std::numeric_limits<size_t>::max()) {
+            break;
+        }
+        for (auto& local : bins) {
+            auto& bin = local[next % size];
+            frontier.insert(frontier.end(), bin.begin(), bin.end());
+            bin.clear();
+        }
+        current = next;
+    }
+    std::vector<W> result(n);
+    for (int v = 0; v < n; ++v) {
+        result[v] = dist[v].load(std::memory_order_relaxed);
+    }
+    return result;
+}
+} // namespace degraph
+
+#endif // MY_DEGRAPH_PATH_HPP
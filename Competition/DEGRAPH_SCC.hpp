@@ -0,0 +1,241 @@
+#ifndef MY_DEGRAPH_SCC_HPP
+#define MY_DEGRAPH_SCC_HPP
+/**
+ * @brief 有向图的强连通分量与拓扑排序
+ *
+ * @brief 强连通分量 scc(g) (迭代Tarjan)，缩点 condensation(g, s)
+ * @brief 拓扑排序 topological_sort(g, order) (Kahn)，找环 find_cycle(g)
+ *
+ * @note 全部用显式栈代替递归，栈在开始时按节点数一次分配，10^8个节点的长链也不会爆栈
+ * @note 适用于csr_t、weighted_csr_t和basic_graph_t；DFS用first_edge/next_edge逐条访问出边，
+ *       拓扑排序和缩点只需要for_each，也可以用于其他图
+ * @note scc的分量编号按拓扑序排列：若有从分量a到分量b的边，则a < b，缩点得到的DAG中边总是从小编号指向大编号
+ *
+ * @example 使用示例
+ * int main()
+ * {
+ *     degraph::graph_t g(4, 4);
+ *     g.add_edge(0, 1), g.add_edge(1, 0), g.add_edge(1, 2), g.add_edge(2, 3);
+ *     degraph::scc_t s = degraph::scc(g); // s.count = 3, s.comp = { 0, 0, 1, 2 }
+ *     degraph::csr_t dag = degraph::condensation(g, s); // 0 -> 1 -> 2
+ *
+ *     std::vector<int> order;
+ *     bool ok = degraph::topological_sort(g, order); // false，0和1成环
+ *     std::vector<int> cycle = degraph::find_cycle(g); // { 0, 1 }
+ *     return 0;
+ * }
+ */
+
+#include "DEGRAPH.hpp"
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace degraph {
+/**
+ * @brief 强连通分量的结果
+ */
+struct scc_t {
+    std::vector<int> comp; // comp[v]为v所在的分量编号，按拓扑序排列
+    int count = 0; // 分量的个数
+
+    std::vector<int> size() const // 每个分量的节点数
+    {
+        std::vector<int> s(count, 0);
+        for (int c : comp) {
+            ++s[c];
+        }
+        return s;
+    }
+};
+
+/**
+ * @brief 迭代Tarjan求强连通分量，时间复杂度O(n + m)
+ * @note 调用栈只保存节点，每个节点的下一条待访问出边存在cursor[u]中；
+ *       除结果外使用5个长度为n的int数组，不会再分配内存
+ */
+template <typename Graph>
+scc_t scc(const Graph& g)
+{
+    const int n = g.vertex_size();
+    scc_t result;
+    std::vector<int>& comp = result.comp;
+    comp.assign(n, -1);
+    // order[u]为u的访问序号，low[u] < 0表示未访问；comp[v] < 0且已访问表示v还在path栈中
+    std::vector<int> order(n), low(n, -1), cursor(n), call(n), path(n);
+    int depth = 0, top = 0, timer = 0, count = 0;
+    auto visit = [&](int u) {
+        order[u] = low[u] = timer++;
+        cursor[u] = first_edge(g, u);
+        call[depth++] = u;
+        path[top++] = u;
+    };
+    for (int s = 0; s < n; ++s) {
+        if (low[s] >= 0) {
+            continue;
+        }
+        visit(s);
+        while (depth > 0) {
+            const int u = call[depth - 1];
+            const int k = cursor[u];
+            if (k >= 0) {
+                cursor[u] = next_edge(g, u, k);
+                const int v = g.to[k];
+                if (low[v] < 0) {
+                    visit(v);
+                } else if (comp[v] < 0) {
+                    low[u] = std::min(low[u], order[v]);
+                }
+                continue;
+            }
+            --depth;
+            if (low[u] == order[u]) {
+                int v;
+                do {
+                    v = path[--top];
+                    comp[v] = count;
+                } while (v != u);
+                ++count;
+            }
+            if (depth > 0) {
+                const int p = call[depth - 1];
+                low[p] = std::min(low[p], low[u]);
+            }
+        }
+    }
+    // Tarjan按逆拓扑序得到分量，翻转编号
+    for (int& c : comp) {
+        c = count - 1 - c;
+    }
+    result.count = count;
+    return result;
+}
+
+/**
+ * @brief 缩点，每个强连通分量成为一个节点
+ * @return 分量之间的DAG，重边只保留一条，id为其中最小的原边编号；每个节点的出边按终点排序
+ */
+template <typename Graph>
+csr_t condensation(const Graph& g, const scc_t& s)
+{
+    const int n = g.vertex_size();
+    csr_t dag;
+    dag.offset.assign(s.count + 1, 0);
+    for (int u = 0; u < n; ++u) {
+        g.for_each(u, [&](int v, int) {
+            if (s.comp[u] != s.comp[v]) {
+                ++dag.offset[s.comp[u] + 1];
+            }
+        });
+    }
+    for (int c = 0; c < s.count; ++c) {
+        dag.offset[c + 1] += dag.offset[c];
+    }
+    std::vector<std::pair<int, int>> edges(dag.offset[s.count]); // (终点, 原边编号)
+    std::vector<int> cursor(dag.offset.begin(), dag.offset.end() - 1);
+    for (int u = 0; u < n; ++u) {
+        g.for_each(u, [&](int v, int e) {
+            if (s.comp[u] != s.comp[v]) {
+                edges[cursor[s.comp[u]]++] = { s.comp[v], e };
+            }
+        });
+    }
+    // 每个分量内排序去重，并压缩到一起
+    dag.to.reserve(edges.size());
+    dag.id.reserve(edges.size());
+    int first = 0;
+    for (int c = 0; c < s.count; ++c) {
+        const int last = dag.offset[c + 1];
+        std::sort(edges.begin() + first, edges.begin() + last);
+        for (int k = first; k < last; ++k) {
+            if (k == first || edges[k].first != edges[k - 1].first) {
+                dag.to.push_back(edges[k].first);
+                dag.id.push_back(edges[k].second);
+            }
+        }
+        first = last;
+        dag.offset[c + 1] = dag.to.size();
+    }
+    return dag;
+}
+
+/**
+ * @brief Kahn拓扑排序
+ * @param order 结果，order[i]为第i个节点；有环时只包含不在环上、也不依赖环的节点
+ * @return 是否无环
+ */
+template <typename Graph>
+bool topological_sort(const Graph& g, std::vector<int>& order)
+{
+    const int n = g.vertex_size();
+    std::vector<int> in(n, 0);
+    for (int u = 0; u < n; ++u) {
+        g.for_each(u, [&](int v, int) { ++in[v]; });
+    }
+    order.clear();
+    order.reserve(n);
+    for (int u = 0; u < n; ++u) {
+        if (in[u] == 0) {
+            order.push_back(u);
+        }
+    }
+    // order同时作为队列
+    for (size_t head = 0; head < order.size(); ++head) {
+        g.for_each(order[head], [&](int v, int) {
+            if (--in[v] == 0) {
+                order.push_back(v);
+            }
+        });
+    }
+    return (int)order.size() == n;
+}
+
+/**
+ * @brief 找一个有向环(迭代DFS)
+ * @return 环上的节点，按边的方向排列(最后一个节点有边指向第一个)；无环时为空
+ * @note 自环返回只含一个节点的环
+ */
+template <typename Graph>
+std::vector<int> find_cycle(const Graph& g)
+{
+    const int n = g.vertex_size();
+    std::vector<char> state(n, 0); // 0：未访问，1：在栈中，2：已完成
+    std::vector<int> cursor(n), call(n);
+    for (int s = 0; s < n; ++s) {
+        if (state[s]) {
+            continue;
+        }
+        int depth = 0;
+        state[s] = 1;
+        cursor[s] = first_edge(g, s);
+        call[depth++] = s;
+        while (depth > 0) {
+            const int u = call[depth - 1];
+            const int k = cursor[u];
+            if (k < 0) {
+                state[u] = 2;
+                --depth;
+                continue;
+            }
+            cursor[u] = next_edge(g, u, k);
+            const int v = g.to[k];
+            if (state[v] == 1) {
+                // call中从v到栈顶即为环
+                int i = depth - 1;
+                while (call[i] != v) {
+                    --i;
+                }
+                return std::vector<int>(call.begin() + i, call.begin() + depth);
+            }
+            if (state[v] == 0) {
+                state[v] = 1;
+                cursor[v] = first_edge(g, v);
+                call[depth++] = v;
+            }
+        }
+    }
+    return {};
+}
+} // namespace degraph
+
+#endif // MY_DEGRAPH_SCC_HPP
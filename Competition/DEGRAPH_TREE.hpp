@@ -0,0 +1,287 @@
+#ifndef MY_DEGRAPH_TREE_HPP
+#define MY_DEGRAPH_TREE_HPP
+/**
+ * @brief 有根树的查询
+ *
+ * @brief 预处理 tree_t(g, root)：父节点、深度、子树大小、重链剖分、DFS序
+ * @brief O(1)最近公共祖先 lca(u, v)，祖先判断 is_ancestor，距离 distance，k级祖先 ancestor(u, k)
+ * @brief 子树区间 subtree(u)，路径区间 for_each_path(u, v, f) (重链剖分，O(log n)段)
+ *
+ * @note 全部迭代实现，除图以外的内存为O(n)(约每个节点10个int)，10^7个节点的链也不会爆栈
+ * @note pos为重链优先的DFS序：子树u占据[pos[u], pos[u] + size[u])，每条重链的pos也连续，
+ *       子树查询和路径查询可以用同一棵线段树/树状数组，按pos下标存放节点的值
+ * @note LCA：对于pos[u] < pos[v]，DFS序区间(pos[u], pos[v]]中父节点的pos的最小值即为pos[lca(u, v)]，
+ *       用分块RMQ求区间最小值：块内用64位单调栈掩码，块间用稀疏表，O(n)空间O(1)查询
+ * @note 图中的边可以是双向的，也可以只有父节点指向子节点的边；不连通时为森林，不在同一棵树中的节点lca为-1
+ *
+ * @example 使用示例
+ * int main()
+ * {
+ *     degraph::graph_t g(5, 8);
+ *     for (auto [u, v] : { std::pair { 0, 1 }, { 0, 2 }, { 1, 3 }, { 1, 4 } }) {
+ *         g.add_edge(u, v), g.add_edge(v, u);
+ *     }
+ *     degraph::tree_t t(g, 0);
+ *     int a = t.lca(3, 4); // 1
+ *     int d = t.distance(3, 2); // 3
+ *     auto [l, r] = t.subtree(1); // 子树1的DFS序区间[l, r)
+ *     t.for_each_path(3, 2, [&](int l, int r) { // 路径3 -> 2上的节点占据的DFS序区间[l, r)
+ *     });
+ *     return 0;
+ * }
+ */
+
+#include "DEGRAPH.hpp"
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace degraph {
+/**
+ * @brief 有根树(或森林)的预处理结果
+ */
+struct tree_t {
+    std::vector<int> parent; // 根的parent为-1
+    std::vector<int> depth; // 根的深度为0
+    std::vector<int> size; // 子树大小
+    std::vector<int> heavy; // 子树最大的子节点，叶子为-1
+    std::vector<int> head; // 所在重链的顶端
+    std::vector<int> pos; // 重链优先的DFS序
+    std::vector<int> order; // order[pos[u]] = u
+
+    tree_t() = default;
+
+    /**
+     * @brief 以root为根预处理，root以外不可达的节点按编号顺序作为其他树的根
+     */
+    template <typename Graph>
+    explicit tree_t(const Graph& g, int root = 0)
+    {
+        build(g, root);
+    }
+
+    template <typename Graph>
+    void build(const Graph& g, int root = 0)
+    {
+        const int n = g.vertex_size();
+        parent.assign(n, -1);
+        depth.assign(n, -1);
+        size.assign(n, 1);
+        heavy.assign(n, -1);
+        head.resize(n);
+        pos.resize(n);
+        order.resize(n);
+
+        // BFS求parent和depth，order暂时存放BFS序
+        int tail = 0;
+        for (int i = -1; i < n; ++i) {
+            const int r = i < 0 ? root : i;
+            if (r >= n || depth[r] >= 0) {
+                continue;
+            }
+            int front = tail;
+            depth[r] = 0;
+            order[tail++] = r;
+            while (front < tail) {
+                const int u = order[front++];
+                g.for_each(u, [&](int v, int) {
+                    if (depth[v] < 0) {
+                        depth[v] = depth[u] + 1;
+                        parent[v] = u;
+                        order[tail++] = v;
+                    }
+                });
+            }
+        }
+        // 按BFS序的逆序累加子树大小，并选出重儿子
+        for (int i = n - 1; i >= 0; --i) {
+            const int u = order[i], p = parent[u];
+            if (p >= 0) {
+                size[p] += size[u];
+                if (heavy[p] < 0 || size[u] > size[heavy[p]]) {
+                    heavy[p] = u;
+                }
+            }
+        }
+        // 重儿子优先的前序DFS，重儿子最后入栈、最先出栈，保证重链的pos连续
+        std::vector<int> stack;
+        stack.reserve(n);
+        int timer = 0;
+        for (int i = 0; i < n; ++i) {
+            const int r = order[i];
+            if (parent[r] >= 0) {
+                continue;
+            }
+            head[r] = r;
+            stack.push_back(r);
+            while (!stack.empty()) {
+                const int u = stack.back();
+                stack.pop_back();
+                pos[u] = timer++;
+                g.for_each(u, [&](int v, int) {
+                    if (parent[v] == u && v != heavy[u]) {
+                        head[v] = v;
+                        stack.push_back(v);
+                    }
+                });
+                if (heavy[u] >= 0) {
+                    head[heavy[u]] = head[u];
+                    stack.push_back(heavy[u]);
+                }
+            }
+        }
+        for (int u = 0; u < n; ++u) {
+            order[pos[u]] = u;
+        }
+        build_rmq();
+    }
+
+    int vertex_size() const
+    {
+        return parent.size();
+    }
+
+    /**
+     * @brief u是否为v的祖先(包括u == v)
+     */
+    bool is_ancestor(int u, int v) const
+    {
+        return pos[u] <= pos[v] && pos[v] < pos[u] + size[u];
+    }
+
+    /**
+     * @brief 最近公共祖先，O(1)；不在同一棵树中时为-1
+     */
+    int lca(int u, int v) const
+    {
+        if (u == v) {
+            return u;
+        }
+        int l = pos[u], r = pos[v];
+        if (l > r) {
+            std::swap(l, r);
+        }
+        const int p = range_min(l + 1, r);
+        return p < 0 ? -1 : order[p];
+    }
+
+    /**
+     * @brief u和v之间的边数，不在同一棵树中时为-1
+     */
+    int distance(int u, int v) const
+    {
+        const int a = lca(u, v);
+        return a < 0 ? -1 : depth[u] + depth[v] - 2 * depth[a];
+    }
+
+    /**
+     * @brief u向上第k个祖先，k > depth[u]时为-1，O(log n)
+     */
+    int ancestor(int u, int k) const
+    {
+        if (k > depth[u]) {
+            return -1;
+        }
+        const int d = depth[u] - k;
+        while (depth[head[u]] > d) {
+            u = parent[head[u]];
+        }
+        return order[pos[u] - (depth[u] - d)];
+    }
+
+    /**
+     * @brief 子树u的DFS序区间[first, second)
+     */
+    std::pair<int, int> subtree(int u) const
+    {
+        return { pos[u], pos[u] + size[u] };
+    }
+
+    /**
+     * @brief 把u到v的路径拆成O(log n)个DFS序区间，对每个区间调用f(l, r)，区间为[l, r)
+     * @param vertices 为true时路径包含lca；为false时不包含，用于边权存放在子节点上的情况
+     * @note u和v必须在同一棵树中，区间的顺序不固定
+     */
+    template <typename F>
+    void for_each_path(int u, int v, F&& f, bool vertices = true) const
+    {
+        while (head[u] != head[v]) {
+            if (depth[head[u]] < depth[head[v]]) {
+                std::swap(u, v);
+            }
+            f(pos[head[u]], pos[u] + 1);
+            u = parent[head[u]];
+        }
+        if (depth[u] > depth[v]) {
+            std::swap(u, v);
+        }
+        const int l = vertices ? pos[u] : pos[u] + 1;
+        if (l <= pos[v]) {
+            f(l, pos[v] + 1);
+        }
+    }
+
+private:
+    static constexpr int BLOCK = 64;
+
+    // 分块RMQ，a[i]为order[i]的父节点的pos(根为-1)
+    std::vector<int> a;
+    std::vector<unsigned long long> mask; // mask[i]：块内[块起点, i]的后缀最小值所在位置
+    std::vector<std::vector<int>> table; // table[k][b]为第b到第b + 2^k - 1块的最小值
+
+    void build_rmq()
+    {
+        const int n = order.size(), blocks = (n + BLOCK - 1) / BLOCK;
+        a.resize(n);
+        mask.resize(n);
+        for (int i = 0; i < n; ++i) {
+            const int p = parent[order[i]];
+            a[i] = p < 0 ? -1 : pos[p];
+        }
+        table.assign(1, std::vector<int>(blocks));
+        for (int b = 0; b < blocks; ++b) {
+            const int first = b * BLOCK, last = std::min(n, first + BLOCK);
+            unsigned long long m = 0;
+            for (int i = first; i < last; ++i) {
+                // 单调栈：弹出不小于a[i]的元素，栈中的元素即为[first, i]的后缀最小值
+                while (m && a[first + 63 - __builtin_clzll(m)] >= a[i]) {
+                    m &= ~(1ULL << (63 - __builtin_clzll(m)));
+                }
+                m |= 1ULL << (i - first);
+                mask[i] = m;
+            }
+            table[0][b] = a[first + __builtin_ctzll(mask[last - 1])];
+        }
+        for (int k = 1; (1 << k) <= blocks; ++k) {
+            const std::vector<int>& prev = table[k - 1];
+            std::vector<int> cur(blocks - (1 << k) + 1);
+            for (size_t b = 0; b < cur.size(); ++b) {
+                cur[b] = std::min(prev[b], prev[b + (1 << (k - 1))]);
+            }
+            table.push_back(std::move(cur));
+        }
+    }
+
+    int block_min(int l, int r) const // l和r在同一块中
+    {
+        const unsigned long long m = mask[r] & (~0ULL << (l % BLOCK));
+        return a[r - r % BLOCK + __builtin_ctzll(m)];
+    }
+
+    int range_min(int l, int r) const // a[l..r]的最小值
+    {
+        const int bl = l / BLOCK, br = r / BLOCK;
+        if (bl == br) {
+            return block_min(l, r);
+        }
+        int result = std::min(block_min(l, bl * BLOCK + BLOCK - 1), block_min(br * BLOCK, r));
+        if (bl + 1 < br) {
+            const int k = 31 - __builtin_clz(br - bl - 1);
+            result = std::min({ result, table[k][bl + 1], table[k][br - (1 << k)] });
+        }
+        return result;
+    }
+};
+} // namespace degraph
+
+#endif // MY_DEGRAPH_TREE_HPP
@@ -1,51 +1,137 @@
+#ifndef MY_DEMATH_HPP
+#define MY_DEMATH_HPP
+#include "../MultiThread/ThreadPool.hpp"
 #include "IO.hpp"
 #include <cmath>
 #include <cstring>
 #include <functional>
+#include <limits>
+#include <queue>
+#include <type_traits>
 #include <vector>
 
 /**
  * @brief 数学库
  *
  * @brief 求最大公约数 gcd
- * @brief 求积分 simpson, romberg
+ * @brief 求积分 simpson, romberg, gauss_kronrod, adaptive_simpson
  * @brief 求梯度 gradient
+ *
+ * @see DEMATH_CUBATURE.hpp 多元函数求积分
+ * @see DEMATH_AUTODIFF.hpp 自动微分求精确的梯度和雅可比矩阵
+ * @see DEMATH_OPTIMIZE.hpp 多元函数最小化
+ * @see DEMATH_NUMBER.hpp 64位模运算(Montgomery, Barrett)，批量求逆元
+ * @see DEMATH_PRIME.hpp 分段筛，素性测试，因数分解
+ * @see DEMATH_FFT.hpp FFT/NTT，卷积与多项式运算
+ * @see DEMATH_LINALG.hpp 稠密矩阵乘法，LU/Cholesky解线性方程组
  */
 
 namespace demath {
 /**
- * @brief 贝祖定理求最大公约数
+ * @brief Stein二进制法求最大公约数
  * @param a 整数a
  * @param b 整数b
- * @return a和b的最大公约数
+ * @return a和b的最大公约数(非负)
  *
- * @note 贝祖定理：gcd(a, b) = gcd(b, a % b)
- * @note 时间复杂度O(log(min(a, b)))
+ * @note gcd(2a, 2b) = 2gcd(a, b)，b为奇数时gcd(2a, b) = gcd(a, b)，gcd(a, b) = gcd(a - b, b)
+ *       只用移位和减法，没有除法，支持到64位整数，可以在编译期求值
+ * @note 时间复杂度O(log(max(a, b)))
  */
-int gcd(int a, int b)
+template <typename T, typename U>
+constexpr std::common_type_t<T, U> gcd(T a, U b)
 {
-    return b == 0 ? a : gcd(b, a % b);
+    using R = std::common_type_t<T, U>;
+    using W = std::make_unsigned_t<R>;
+    W x = W(a), y = W(b);
+    if constexpr (std::is_signed_v<R>) {
+        x = a < 0 ? W(0) - x : x;
+        y = b < 0 ? W(0) - y : y;
+    }
+    if (x == 0 || y == 0) {
+        return R(x | y);
+    }
+    const int shift = __builtin_ctzll(x | y);
+    x >>= __builtin_ctzll(x);
+    do {
+        y >>= __builtin_ctzll(y);
+        if (x > y) {
+            W t = x;
+            x = y;
+            y = t;
+        }
+        y -= x;
+    } while (y != 0);
+    return R(x << shift);
 }
 
 /**
  * @brief 求x,y使得ax + by = gcd(a, b)
+ * @note 迭代实现，不会栈溢出，支持到64位整数(a, b非负)，可以在编译期求值
  */
-int extend_gcd(int a, int b, int& x, int& y)
+template <typename T>
+constexpr T extend_gcd(T a, T b, T& x, T& y)
 {
-    if (b == 0) {
-        x = 1;
-        y = 0;
-        return a;
+    T x0 = 1, y0 = 0, x1 = 0, y1 = 1;
+    while (b != 0) {
+        T q = a / b, t = a - q * b;
+        a = b, b = t;
+        t = x0 - q * x1, x0 = x1, x1 = t;
+        t = y0 - q * y1, y0 = y1, y1 = t;
+    }
+    x = x0, y = y0;
+    return a;
+}
+
+/**
+ * @brief 判断f是否支持批量求值 f(const double* x, double* y, int n)
+ * @note 支持批量求值的f可以在内部用SIMD一次处理多个点
+ */
+template <typename T>
+constexpr bool is_batch_v = std::is_invocable_v<const T&, const double*, double*, int>;
+
+constexpr int EVAL_BATCH = 64; // 每次批量求值的最大点数
+
+/**
+ * @brief 在x[0..n)处求值，结果写入y
+ * @note 支持批量求值的f一次调用完成，否则逐点调用f(x)
+ */
+template <typename T>
+void evaluate(const T& f, const double* x, double* y, int n)
+{
+    if constexpr (is_batch_v<T>) {
+        f(x, y, n);
     } else {
-        int r = extend_gcd(b, a % b, y, x);
-        y -= a / b * x;
-        return r;
+        for (int i = 0; i < n; ++i) {
+            y[i] = f(x[i]);
+        }
+    }
+}
+
+/**
+ * @brief 求和 f(x0) + f(x0 + h) + ... + f(x0 + (count - 1) * h)
+ * @note 每EVAL_BATCH个点批量求值一次
+ */
+template <typename T>
+double sum_nodes(const T& f, double x0, double h, long long count)
+{
+    double x[EVAL_BATCH], y[EVAL_BATCH];
+    double ans = 0;
+    for (long long j = 0; j < count; j += EVAL_BATCH) {
+        int n = count - j < EVAL_BATCH ? count - j : EVAL_BATCH;
+        for (int i = 0; i < n; ++i) {
+            x[i] = x0 + (j + i) * h;
+        }
+        evaluate(f, x, y, n);
+        for (int i = 0; i < n; ++i) {
+            ans += y[i];
+        }
     }
+    return ans;
 }
 
 /**
  * @brief 一元函数simpson法求积分
- * @param f 函数
+ * @param f 函数，可以是double(double)或批量求值函数
  * @param a 下界， b 上界
  * @param n 分割数，n越大越精确
  * @return 积分结果
@@ -54,37 +140,29 @@ template <typename T>
 double simpson(const T& f, double a, double b, int n)
 {
     const double h = (b - a) / n;
-    double ans = f(a) + f(b);
-    for (int i = 1; i < n; i += 2) {
-        ans += 4 * f(a + i * h);
-    }
-    for (int i = 2; i < n; i += 2) {
-        ans += 2 * f(a + i * h);
-    }
+    double ends[2] = { a, b }, fends[2];
+    evaluate(f, ends, fends, 2);
+    double ans = fends[0] + fends[1];
+    ans += 4 * sum_nodes(f, a + h, 2 * h, n / 2);
+    ans += 2 * sum_nodes(f, a + 2 * h, 2 * h, (n - 1) / 2);
     return ans * h / 3;
 }
 
 /**
- * @brief 一元函数romberg法求积分
- * @param f 函数
- * @param a 下界， b 上界
- * @param eps 精度
+ * @brief romberg外推，midpoint_sum(h, k)返回新一层k个中点a + h/2 + j * h处的函数值之和
  */
-template <typename T>
-double romberg(const T& f, double a, double b, double eps = 1e-6)
+template <typename T, typename S>
+double romberg_with(const T& f, double a, double b, double eps, const S& midpoint_sum)
 {
     std::vector<double> t;
     double h = b - a, last, curr;
     int k = 1, i = 1;
-    t.push_back(h * (f(a) + f(b)) / 2);
+    double ends[2] = { a, b }, fends[2];
+    evaluate(f, ends, fends, 2);
+    t.push_back(h * (fends[0] + fends[1]) / 2);
     do {
         last = t.back();
-        curr = 0;
-        double x = a + h / 2;
-        for (int j = 0; j < k; ++j) {
-            curr += f(x);
-            x += h;
-        }
+        curr = midpoint_sum(h, k);
         curr = (t[0] + h * curr) / 2;
         double k1 = 4.0 / 3.0;
         double k2 = 1.0 / 3.0;
@@ -103,6 +181,248 @@ double romberg(const T& f, double a, double b, double eps = 1e-6)
     return curr;
 }
 
+/**
+ * @brief 一元函数romberg法求积分
+ * @param f 函数，可以是double(double)或批量求值函数
+ * @param a 下界， b 上界
+ * @param eps 精度
+ */
+template <typename T>
+double romberg(const T& f, double a, double b, double eps = 1e-6)
+{
+    return romberg_with(f, a, b, eps, [&](double h, int k) {
+        return sum_nodes(f, a + h / 2, h, k);
+    });
+}
+
+/**
+ * @brief 一元函数romberg法求积分，每一层的新节点分块在线程池上求值
+ * @param pool 线程池，f需要是线程安全的
+ * @note 分块求和后按块的顺序累加，结果与线程调度无关
+ */
+template <typename T>
+double romberg(const T& f, double a, double b, ThreadPool& pool, double eps = 1e-6)
+{
+    constexpr int BLOCK = 4096;
+    std::vector<double> partial;
+    return romberg_with(f, a, b, eps, [&](double h, int k) {
+        int blocks = (k + BLOCK - 1) / BLOCK;
+        partial.assign(blocks, 0);
+        parallel_for(pool, 0, blocks, [&](size_t lo, size_t hi) {
+            for (size_t c = lo; c < hi; ++c) {
+                long long first = c * BLOCK;
+                long long count = k - first < BLOCK ? k - first : BLOCK;
+                partial[c] = sum_nodes(f, a + h / 2 + first * h, h, count);
+            }
+        }, 1);
+        double ans = 0;
+        for (double p : partial) {
+            ans += p;
+        }
+        return ans;
+    });
+}
+
+/**
+ * @brief 自适应积分的结果
+ * @param value 积分值， error 误差估计， evals 函数求值次数
+ */
+struct integral_t {
+    double value;
+    double error;
+    long long evals;
+};
+
+/**
+ * @brief 自适应积分中的一个子区间，按误差排序
+ */
+struct segment_t {
+    double a, b;
+    double value, error;
+    double f[5]; // adaptive_simpson使用，a, a + h/4, a + h/2, a + 3h/4, b处的函数值
+    bool operator<(const segment_t& other) const
+    {
+        return error < other.error;
+    }
+};
+
+constexpr double KRONROD_X[11] = { // 21点Gauss-Kronrod节点(正半轴)
+    0.995657163025808080735527280689003, 0.973906528517171720077964012084452,
+    0.930157491355708226001207180059508, 0.865063366688984510732096688423493,
+    0.780817726586416897063717578345042, 0.679409568299024406234327365114874,
+    0.562757134668604683339000099272694, 0.433395394129247190799265943165784,
+    0.294392862701460198131126603103866, 0.148874338981631210884826001129720,
+    0.000000000000000000000000000000000
+};
+constexpr double KRONROD_W[11] = { // 21点Kronrod权重
+    0.011694638867371874278064396062192, 0.032558162307964727478818972459390,
+    0.054755896574351996031381300244580, 0.075039674810919952767043140916190,
+    0.093125454583697605535065465083366, 0.109387158802297641899210590325805,
+    0.123491976262065851077208031875780, 0.134709217311473325928054001771707,
+    0.142775938577060080797094273138717, 0.147739104901338491374841515972068,
+    0.149445554002916905664936468389821
+};
+constexpr double GAUSS_W[5] = { // 10点Gauss权重，对应KRONROD_X[1], [3], [5], [7], [9]
+    0.066671344308688137593568809893332, 0.149451349150580593145776339657697,
+    0.219086362515982043995534934228163, 0.269266719309996355091226921569469,
+    0.295524224714752870173892994651338
+};
+
+/**
+ * @brief 写出[a, b]上21个Kronrod节点，x[0]为中点，x[2i+1], x[2i+2]关于中点对称
+ */
+inline void kronrod_nodes(double a, double b, double* x)
+{
+    const double center = (a + b) / 2, half = (b - a) / 2;
+    x[0] = center;
+    for (int i = 0; i < 10; ++i) {
+        x[2 * i + 1] = center - half * KRONROD_X[i];
+        x[2 * i + 2] = center + half * KRONROD_X[i];
+    }
+}
+
+/**
+ * @brief 由21个节点上的函数值计算积分及误差估计(与QUADPACK qk21相同)
+ */
+inline segment_t kronrod_segment(double a, double b, const double* y)
+{
+    const double half = (b - a) / 2;
+    double resk = y[0] * KRONROD_W[10], resg = 0;
+    for (int i = 0; i < 10; ++i) {
+        resk += (y[2 * i + 1] + y[2 * i + 2]) * KRONROD_W[i];
+        if (i & 1) {
+            resg += (y[2 * i + 1] + y[2 * i + 2]) * GAUSS_W[i / 2];
+        }
+    }
+    const double mean = resk / 2;
+    double resabs = std::abs(y[0]) * KRONROD_W[10], resasc = std::abs(y[0] - mean) * KRONROD_W[10];
+    for (int i = 0; i < 10; ++i) {
+        resabs += (std::abs(y[2 * i + 1]) + std::abs(y[2 * i + 2])) * KRONROD_W[i];
+        resasc += (std::abs(y[2 * i + 1] - mean) + std::abs(y[2 * i + 2] - mean)) * KRONROD_W[i];
+    }
+    resabs *= std::abs(half), resasc *= std::abs(half);
+    double error = std::abs((resk - resg) * half);
+    if (resasc != 0 && error != 0) {
+        error = resasc * std::min(1.0, std::pow(200 * error / resasc, 1.5));
+    }
+    const double epmach = std::numeric_limits<double>::epsilon();
+    if (resabs > std::numeric_limits<double>::min() / (50 * epmach)) {
+        error = std::max(epmach * 50 * resabs, error);
+    }
+    return segment_t { a, b, resk * half, error, {} };
+}
+
+/**
+ * @brief 全局误差队列的自适应积分框架
+ * @param init 计算[a, b]的初始子区间
+ * @param split 将一个子区间二分，两个子区间所需的新节点一次批量求值
+ * @note 每次取出误差最大的子区间二分，直到总误差不超过eps * max(1, |积分值|)
+ */
+template <typename I, typename S>
+integral_t adaptive_with(double a, double b, double eps, long long max_eval, const I& init, const S& split)
+{
+    integral_t res { 0, 0, 0 };
+    std::priority_queue<segment_t> heap;
+    heap.push(init(a, b, res.evals));
+    res.value = heap.top().value, res.error = heap.top().error;
+    while (res.error > eps * std::max(1.0, std::abs(res.value)) && res.evals < max_eval) {
+        segment_t seg = heap.top();
+        const double m = (seg.a + seg.b) / 2;
+        if (m <= std::min(seg.a, seg.b) || m >= std::max(seg.a, seg.b)) {
+            break; // 区间已经无法再细分
+        }
+        heap.pop();
+        segment_t left, right;
+        split(seg, left, right, res.evals);
+        res.value += left.value + right.value - seg.value;
+        res.error += left.error + right.error - seg.error;
+        heap.push(left), heap.push(right);
+    }
+    // 重新求和，避免增量更新累积的舍入误差
+    res.value = res.error = 0;
+    for (; !heap.empty(); heap.pop()) {
+        res.value += heap.top().value;
+        res.error += heap.top().error;
+    }
+    return res;
+}
+
+/**
+ * @brief 一元函数自适应Gauss-Kronrod(G10K21)求积分
+ * @param f 函数，可以是double(double)或批量求值函数
+ * @param a 下界， b 上界
+ * @param eps 相对精度(积分值小于1时为绝对精度)
+ * @param max_eval 最大求值次数
+ * @note 每次二分时两个子区间的42个节点一次批量求值，适合光滑但代价高的被积函数
+ */
+template <typename T>
+integral_t gauss_kronrod(const T& f, double a, double b, double eps = 1e-10, long long max_eval = 1 << 20)
+{
+    auto init = [&](double a, double b, long long& evals) {
+        double x[21], y[21];
+        kronrod_nodes(a, b, x);
+        evaluate(f, x, y, 21);
+        evals += 21;
+        return kronrod_segment(a, b, y);
+    };
+    auto split = [&](const segment_t& seg, segment_t& left, segment_t& right, long long& evals) {
+        const double m = (seg.a + seg.b) / 2;
+        double x[42], y[42];
+        kronrod_nodes(seg.a, m, x);
+        kronrod_nodes(m, seg.b, x + 21);
+        evaluate(f, x, y, 42);
+        evals += 42;
+        left = kronrod_segment(seg.a, m, y);
+        right = kronrod_segment(m, seg.b, y + 21);
+    };
+    return adaptive_with(a, b, eps, max_eval, init, split);
+}
+
+/**
+ * @brief 由5个等距点上的函数值计算子区间的simpson积分
+ * @note 误差估计为|S(左半) + S(右半) - S(整体)| / 15，积分值带Richardson外推
+ */
+inline segment_t simpson_segment(double a, double b, const double* y)
+{
+    const double h = (b - a) / 12;
+    const double whole = 2 * h * (y[0] + 4 * y[2] + y[4]);
+    const double halves = h * (y[0] + 4 * y[1] + 2 * y[2] + 4 * y[3] + y[4]);
+    const double delta = (halves - whole) / 15;
+    return segment_t { a, b, halves + delta, std::abs(delta), { y[0], y[1], y[2], y[3], y[4] } };
+}
+
+/**
+ * @brief 一元函数自适应simpson法求积分(全局误差队列)
+ * @param f 函数，可以是double(double)或批量求值函数
+ * @param a 下界， b 上界
+ * @param eps 相对精度(积分值小于1时为绝对精度)
+ * @param max_eval 最大求值次数
+ * @note 与递归版本不同，总是细分误差最大的子区间，每次二分只需4个新节点并一次批量求值
+ *       适合不够光滑的被积函数
+ */
+template <typename T>
+integral_t adaptive_simpson(const T& f, double a, double b, double eps = 1e-8, long long max_eval = 1 << 20)
+{
+    auto init = [&](double a, double b, long long& evals) {
+        const double h = (b - a) / 4;
+        double x[5] = { a, a + h, a + 2 * h, a + 3 * h, b }, y[5];
+        evaluate(f, x, y, 5);
+        evals += 5;
+        return simpson_segment(a, b, y);
+    };
+    auto split = [&](const segment_t& seg, segment_t& left, segment_t& right, long long& evals) {
+        const double h = (seg.b - seg.a) / 8;
+        double x[4] = { seg.a + h, seg.a + 3 * h, seg.a + 5 * h, seg.a + 7 * h }, y[4];
+        evaluate(f, x, y, 4);
+        evals += 4;
+        double l[5] = { seg.f[0], y[0], seg.f[1], y[1], seg.f[2] };
+        double r[5] = { seg.f[2], y[2], seg.f[3], y[3], seg.f[4] };
+        left = simpson_segment(seg.a, (seg.a + seg.b) / 2, l);
+        right = simpson_segment((seg.a + seg.b) / 2, seg.b, r);
+    };
+    return adaptive_with(a, b, eps, max_eval, init, split);
+}
+
 /**
  * @brief 一元函数求梯度
  * @param f 函数
@@ -115,4 +435,6 @@ double gradient(const T& f, double x, double h = 1e-6)
 {
     return (f(x + h) - f(x - h)) / (2 * h);
 }
-} // namespace demath
\ No newline at end of file
+} // namespace demath
+
+#endif // MY_DEMATH_HPP
\ No newline at end of file
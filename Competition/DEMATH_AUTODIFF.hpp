@@ -0,0 +1,313 @@
+#ifndef MY_DEMATH_AUTODIFF_HPP
+#define MY_DEMATH_AUTODIFF_HPP
+/**
+ * @brief 自动微分，得到精确的导数(没有差分的截断误差)
+ *
+ * @brief 前向模式 dual_t (对偶数)，derivative 求一元函数的导数，jacobian 求雅可比矩阵
+ * @brief 反向模式 var_t (计算图记录在tape_t中)，gradient 求多元函数的梯度
+ *
+ * @note 被求导的函数需要写成泛型的，例如 [](const auto& x) { return sin(x[0]) * x[1]; }
+ *       数学函数不要加std::前缀，由ADL找到dual_t和var_t的重载
+ * @note 前向模式每个自变量需要一次求值，反向模式一次求值加一次反向传播即可得到完整梯度
+ *
+ * @example 使用示例
+ * int main()
+ * {
+ *     auto f = [](const auto& x) { return x[0] * x[0] * x[1] + exp(x[1]); };
+ *     std::vector<double> g;
+ *     double y = demath::gradient(f, { 1.0, 2.0 }, g); // g = { 4, 1 + e^2 }
+ *
+ *     auto h = [](const auto& x) { using std::sin; return sin(x) * x; };
+ *     double d = demath::derivative(h, 1.0); // sin(1) + cos(1)
+ *     return 0;
+ * }
+ */
+
+#include "DEMATH.hpp"
+#include <cmath>
+#include <vector>
+
+namespace demath {
+/**
+ * @brief 对偶数 value + grad * ε (ε^2 = 0)
+ * @note T可以是dual_t本身，嵌套后可以求高阶导数
+ */
+template <typename T>
+struct dual_t {
+    T value, grad;
+
+    dual_t(const T& value = T(), const T& grad = T())
+        : value(value)
+        , grad(grad)
+    {
+    }
+
+    friend dual_t operator+(const dual_t& a, const dual_t& b) { return { a.value + b.value, a.grad + b.grad }; }
+    friend dual_t operator-(const dual_t& a, const dual_t& b) { return { a.value - b.value, a.grad - b.grad }; }
+    friend dual_t operator*(const dual_t& a, const dual_t& b) { return { a.value * b.value, a.grad * b.value + a.value * b.grad }; }
+    friend dual_t operator/(const dual_t& a, const dual_t& b)
+    {
+        return { a.value / b.value, (a.grad * b.value - a.value * b.grad) / (b.value * b.value) };
+    }
+    friend dual_t operator-(const dual_t& a) { return { -a.value, -a.grad }; }
+    dual_t& operator+=(const dual_t& b) { return *this = *this + b; }
+    dual_t& operator-=(const dual_t& b) { return *this = *this - b; }
+    dual_t& operator*=(const dual_t& b) { return *this = *this * b; }
+    dual_t& operator/=(const dual_t& b) { return *this = *this / b; }
+    friend bool operator<(const dual_t& a, const dual_t& b) { return a.value < b.value; }
+    friend bool operator>(const dual_t& a, const dual_t& b) { return a.value > b.value; }
+    friend bool operator<=(const dual_t& a, const dual_t& b) { return a.value <= b.value; }
+    friend bool operator>=(const dual_t& a, const dual_t& b) { return a.value >= b.value; }
+
+    // 链式法则：f(a + bε) = f(a) + f'(a)bε
+    friend dual_t sin(const dual_t& x) { using std::cos, std::sin; return { sin(x.value), cos(x.value) * x.grad }; }
+    friend dual_t cos(const dual_t& x) { using std::cos, std::sin; return { cos(x.value), -sin(x.value) * x.grad }; }
+    friend dual_t tan(const dual_t& x)
+    {
+        using std::tan;
+        T t = tan(x.value);
+        return { t, (t * t + 1) * x.grad };
+    }
+    friend dual_t exp(const dual_t& x)
+    {
+        using std::exp;
+        T e = exp(x.value);
+        return { e, e * x.grad };
+    }
+    friend dual_t log(const dual_t& x) { using std::log; return { log(x.value), x.grad / x.value }; }
+    friend dual_t sqrt(const dual_t& x)
+    {
+        using std::sqrt;
+        T s = sqrt(x.value);
+        return { s, x.grad / (s + s) };
+    }
+    friend dual_t tanh(const dual_t& x)
+    {
+        using std::tanh;
+        T t = tanh(x.value);
+        return { t, (1 - t * t) * x.grad };
+    }
+    friend dual_t atan(const dual_t& x) { using std::atan; return { atan(x.value), x.grad / (x.value * x.value + 1) }; }
+    friend dual_t abs(const dual_t& x) { return x.value < T() ? -x : x; }
+    friend dual_t pow(const dual_t& x, const dual_t& p) { return exp(p * log(x)); }
+    friend dual_t pow(const dual_t& x, double p)
+    {
+        using std::pow;
+        return { pow(x.value, p), p * pow(x.value, p - 1) * x.grad };
+    }
+};
+
+/**
+ * @brief 反向模式的计算图
+ * @note 每个节点记录至多两个父节点及对应的偏导数，节点数组只清空不释放，重复求梯度时不再分配内存
+ * @note 同一线程同时只有一个活动的tape，由activate/deactivate切换
+ */
+struct tape_t {
+    struct node_t {
+        int parent[2];
+        double partial[2];
+    };
+    std::vector<node_t> nodes;
+    std::vector<double> adjoint;
+
+    static tape_t*& active()
+    {
+        thread_local tape_t* tape = nullptr;
+        return tape;
+    }
+
+    int push(int p0, double d0, int p1 = -1, double d1 = 0)
+    {
+        nodes.push_back(node_t { { p0, p1 }, { d0, d1 } });
+        return nodes.size() - 1;
+    }
+
+    void clear()
+    {
+        nodes.clear();
+    }
+
+    /**
+     * @brief 从节点y开始反向传播，adjoint[i]为y对节点i的偏导数
+     */
+    void backward(int y)
+    {
+        adjoint.assign(nodes.size(), 0);
+        adjoint[y] = 1;
+        for (int i = y; i >= 0; --i) {
+            const double a = adjoint[i];
+            if (a == 0) {
+                continue;
+            }
+            const node_t& node = nodes[i];
+            if (node.parent[0] >= 0) {
+                adjoint[node.parent[0]] += a * node.partial[0];
+            }
+            if (node.parent[1] >= 0) {
+                adjoint[node.parent[1]] += a * node.partial[1];
+            }
+        }
+    }
+};
+
+/**
+ * @brief 反向模式的变量，运算时在活动的tape上记录节点
+ * @note index为-1表示常数，不会记录在tape上
+ */
+struct var_t {
+    double value;
+    int index;
+
+    var_t(double value = 0)
+        : value(value)
+        , index(-1)
+    {
+    }
+    var_t(double value, int index)
+        : value(value)
+        , index(index)
+    {
+    }
+
+    static var_t unary(const var_t& a, double value, double d)
+    {
+        if (a.index < 0) {
+            return var_t(value);
+        }
+        return var_t(value, tape_t::active()->push(a.index, d));
+    }
+    static var_t binary(const var_t& a, const var_t& b, double value, double da, double db)
+    {
+        if (a.index < 0 && b.index < 0) {
+            return var_t(value);
+        }
+        return var_t(value, tape_t::active()->push(a.index, da, b.index, db));
+    }
+
+    friend var_t operator+(const var_t& a, const var_t& b) { return binary(a, b, a.value + b.value, 1, 1); }
+    friend var_t operator-(const var_t& a, const var_t& b) { return binary(a, b, a.value - b.value, 1, -1); }
+    friend var_t operator*(const var_t& a, const var_t& b) { return binary(a, b, a.value * b.value, b.value, a.value); }
+    friend var_t operator/(const var_t& a, const var_t& b)
+    {
+        const double q = a.value / b.value;
+        return binary(a, b, q, 1 / b.value, -q / b.value);
+    }
+    friend var_t operator-(const var_t& a) { return unary(a, -a.value, -1); }
+    var_t& operator+=(const var_t& b) { return *this = *this + b; }
+    var_t& operator-=(const var_t& b) { return *this = *this - b; }
+    var_t& operator*=(const var_t& b) { return *this = *this * b; }
+    var_t& operator/=(const var_t& b) { return *this = *this / b; }
+    friend bool operator<(const var_t& a, const var_t& b) { return a.value < b.value; }
+    friend bool operator>(const var_t& a, const var_t& b) { return a.value > b.value; }
+    friend bool operator<=(const var_t& a, const var_t& b) { return a.value <= b.value; }
+    friend bool operator>=(const var_t& a, const var_t& b) { return a.value >= b.value; }
+
+    friend var_t sin(const var_t& x) { return unary(x, std::sin(x.value), std::cos(x.value)); }
+    friend var_t cos(const var_t& x) { return unary(x, std::cos(x.value), -std::sin(x.value)); }
+    friend var_t tan(const var_t& x)
+    {
+        const double t = std::tan(x.value);
+        return unary(x, t, 1 + t * t);
+    }
+    friend var_t exp(const var_t& x)
+    {
+        const double e = std::exp(x.value);
+        return unary(x, e, e);
+    }
+    friend var_t log(const var_t& x) { return unary(x, std::log(x.value), 1 / x.value); }
+    friend var_t sqrt(const var_t& x)
+    {
+        const double s = std::sqrt(x.value);
+        return unary(x, s, 0.5 / s);
+    }
+    friend var_t tanh(const var_t& x)
+    {
+        const double t = std::tanh(x.value);
+        return unary(x, t, 1 - t * t);
+    }
+    friend var_t atan(const var_t& x) { return unary(x, std::atan(x.value), 1 / (1 + x.value * x.value)); }
+    friend var_t abs(const var_t& x) { return unary(x, std::abs(x.value), x.value < 0 ? -1 : 1); }
+    friend var_t pow(const var_t& x, const var_t& p)
+    {
+        const double v = std::pow(x.value, p.value);
+        return binary(x, p, v, p.value * std::pow(x.value, p.value - 1), x.value > 0 ? v * std::log(x.value) : 0);
+    }
+};
+
+/**
+ * @brief 前向模式求一元函数的导数
+ * @param f 泛型函数，接受dual_t<double>
+ * @param x 求导点
+ * @return 导数
+ */
+template <typename F>
+double derivative(const F& f, double x)
+{
+    return f(dual_t<double>(x, 1)).grad;
+}
+
+/**
+ * @brief 反向模式求多元函数的梯度
+ * @param f 泛型函数，接受const std::vector<var_t>&，返回var_t
+ * @param x 求导点
+ * @param g 输出梯度，g[i] = ∂f/∂x[i]
+ * @return f(x)
+ * @note 使用线程局部的tape，重复调用时不再分配内存；代价约为一次求值的常数倍，与维度无关
+ */
+template <typename F>
+double gradient(const F& f, const std::vector<double>& x, std::vector<double>& g)
+{
+    thread_local tape_t tape;
+    thread_local std::vector<var_t> vars;
+    tape_t* previous = tape_t::active();
+    tape_t::active() = &tape;
+    tape.clear();
+    vars.resize(x.size());
+    for (size_t i = 0; i < x.size(); ++i) {
+        vars[i] = var_t(x[i], tape.push(-1, 0));
+    }
+    var_t y = f(static_cast<const std::vector<var_t>&>(vars));
+    g.assign(x.size(), 0);
+    if (y.index >= 0) {
+        tape.backward(y.index);
+        for (size_t i = 0; i < x.size(); ++i) {
+            g[i] = tape.adjoint[i];
+        }
+    }
+    tape_t::active() = previous;
+    return y.value;
+}
+
+/**
+ * @brief 前向模式求雅可比矩阵
+ * @param f 泛型函数，接受const std::vector<dual_t<double>>&，返回std::vector<dual_t<double>>
+ * @param x 求导点
+ * @param J 输出雅可比矩阵，J[i][j] = ∂f_i/∂x[j]
+ * @return f(x)
+ * @note 每个自变量求值一次，共x.size()次
+ */
+template <typename F>
+std::vector<double> jacobian(const F& f, const std::vector<double>& x, std::vector<std::vector<double>>& J)
+{
+    std::vector<dual_t<double>> vars(x.begin(), x.end());
+    std::vector<double> y;
+    for (size_t j = 0; j < x.size(); ++j) {
+        vars[j].grad = 1;
+        std::vector<dual_t<double>> out = f(static_cast<const std::vector<dual_t<double>>&>(vars));
+        vars[j].grad = 0;
+        if (j == 0) {
+            y.resize(out.size());
+            J.assign(out.size(), std::vector<double>(x.size()));
+            for (size_t i = 0; i < out.size(); ++i) {
+                y[i] = out[i].value;
+            }
+        }
+        for (size_t i = 0; i < out.size(); ++i) {
+            J[i][j] = out[i].grad;
+        }
+    }
+    return y;
+}
+} // namespace demath
+
+#endif // MY_DEMATH_AUTODIFF_HPP
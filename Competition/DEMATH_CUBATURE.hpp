@@ -0,0 +1,441 @@
+#ifndef MY_DEMATH_CUBATURE_HPP
+#define MY_DEMATH_CUBATURE_HPP
+/**
+ * @brief 多元函数求积分
+ *
+ * @brief 自适应Genz-Malik法 genz_malik (适合3~8维的光滑被积函数)
+ * @brief 加扰Sobol序列的拟蒙特卡洛法 sobol_qmc (适合高维或不光滑的被积函数)
+ *
+ * @note 被积函数可以是double f(const double* x)，x为dim个坐标
+ *       也可以是批量求值函数f(const double* x, double* y, int n)，x为n个点按行排列
+ * @note 传入线程池时，点集分块在多个线程上求值，f需要是线程安全的
+ *
+ * @example 使用示例
+ * int main()
+ * {
+ *     auto f = [](const double* x) { return std::exp(-(x[0] * x[0] + x[1] * x[1] + x[2] * x[2])); };
+ *     std::vector<double> a(3, 0), b(3, 1);
+ *     ThreadPool pool(4);
+ *     demath::integral_t r = demath::genz_malik(f, a, b, pool, 1e-8);
+ *     demath::integral_t q = demath::sobol_qmc(f, a, b, pool, 1 << 16);
+ *     printf("%.10f +- %.2e, %.10f +- %.2e\n", r.value, r.error, q.value, q.error);
+ *     return 0;
+ * }
+ */
+
+#include "DEMATH.hpp"
+#include "RANDOM.hpp"
+#include <stdexcept>
+
+namespace demath {
+/**
+ * @brief 在n个点上求值，x为n * dim个坐标，结果写入y
+ * @param pool 线程池，为nullptr时在当前线程求值
+ * @note 支持批量求值的f每次最多处理EVAL_BATCH个点
+ */
+template <typename T>
+void evaluate_points(const T& f, int dim, const double* x, double* y, long long n, ThreadPool* pool)
+{
+    auto run = [&](size_t lo, size_t hi) {
+        if constexpr (is_batch_v<T>) {
+            for (size_t i = lo; i < hi; i += EVAL_BATCH) {
+                const int m = std::min<size_t>(EVAL_BATCH, hi - i);
+                f(x + i * dim, y + i, m);
+            }
+        } else {
+            for (size_t i = lo; i < hi; ++i) {
+                y[i] = f(x + i * dim);
+            }
+        }
+    };
+    if (pool) {
+        parallel_for(*pool, 0, n, run, EVAL_BATCH);
+    } else {
+        run(0, n);
+    }
+}
+
+/**
+ * @brief Genz-Malik法中的一个子区域
+ * @param c 中心， h 各维的半宽
+ * @param split 下一次二分的维度(四阶差分最大的维度)
+ */
+struct region_t {
+    std::vector<double> c, h;
+    double value, error;
+    int split;
+    bool operator<(const region_t& other) const
+    {
+        return error < other.error;
+    }
+};
+
+/**
+ * @brief Genz-Malik 7阶求积公式，内嵌5阶公式用于误差估计
+ * @note dim维需要 2^dim + 2dim^2 + 2dim + 1 个点
+ */
+struct genz_malik_rule {
+    int dim, points;
+    double w[5], v[4]; // 7阶与5阶公式的权重
+    static constexpr double L2 = 0.35856858280031809199064515390793; // sqrt(9/70)
+    static constexpr double L4 = 0.94868329805051379959966806332982; // sqrt(9/10)，L3与L4相同
+    static constexpr double L5 = 0.68824720161168529772162873429362; // sqrt(9/19)
+
+    genz_malik_rule(int dim)
+        : dim(dim)
+        , points((1 << dim) + 2 * dim * dim + 2 * dim + 1)
+    {
+        const double d = dim;
+        w[0] = (12824 - 9120 * d + 400 * d * d) / 19683;
+        w[1] = 980.0 / 6561;
+        w[2] = (1820 - 400 * d) / 19683;
+        w[3] = 200.0 / 19683;
+        w[4] = 6859.0 / 19683 / (1 << dim);
+        v[0] = (729 - 950 * d + 50 * d * d) / 729;
+        v[1] = 245.0 / 486;
+        v[2] = (265 - 100 * d) / 1458;
+        v[3] = 25.0 / 729;
+    }
+
+    /**
+     * @brief 写出子区域上的求积节点
+     * @note 顺序为：中心，每维的-L2, +L2, -L3, +L3，每对维度的4个(±L4, ±L4)，2^dim个(±L5, ...)
+     */
+    void nodes(const region_t& r, double* x) const
+    {
+        auto put = [&](double*& p) {
+            std::copy(r.c.begin(), r.c.end(), p);
+            p += dim;
+            return p - dim;
+        };
+        double* p = x;
+        put(p);
+        for (int i = 0; i < dim; ++i) {
+            put(p)[i] -= L2 * r.h[i];
+            put(p)[i] += L2 * r.h[i];
+            put(p)[i] -= L4 * r.h[i];
+            put(p)[i] += L4 * r.h[i];
+        }
+        for (int i = 0; i < dim; ++i) {
+            for (int j = i + 1; j < dim; ++j) {
+                for (int s = 0; s < 4; ++s) {
+                    double* q = put(p);
+                    q[i] += (s & 1 ? L4 : -L4) * r.h[i];
+                    q[j] += (s & 2 ? L4 : -L4) * r.h[j];
+                }
+            }
+        }
+        for (int s = 0; s < (1 << dim); ++s) {
+            double* q = put(p);
+            for (int i = 0; i < dim; ++i) {
+                q[i] += (s >> i & 1 ? L5 : -L5) * r.h[i];
+            }
+        }
+    }
+
+    /**
+     * @brief 由节点上的函数值计算积分、误差估计和下一次二分的维度
+     */
+    void apply(region_t& r, const double* y) const
+    {
+        const double f1 = y[0];
+        double sum2 = 0, sum3 = 0, sum4 = 0, sum5 = 0, max_diff = -1;
+        const double* p = y + 1;
+        for (int i = 0; i < dim; ++i, p += 4) {
+            double s2 = p[0] + p[1], s3 = p[2] + p[3];
+            sum2 += s2, sum3 += s3;
+            double diff = std::abs(s2 - 2 * f1 - (s3 - 2 * f1) * (L2 * L2) / (L4 * L4));
+            if (diff > max_diff || (diff == max_diff && r.h[i] > r.h[r.split])) {
+                max_diff = diff, r.split = i;
+            }
+        }
+        for (int k = 0; k < 2 * dim * (dim - 1); ++k) {
+            sum4 += *p++;
+        }
+        for (int k = 0; k < (1 << dim); ++k) {
+            sum5 += *p++;
+        }
+        double volume = 1;
+        for (int i = 0; i < dim; ++i) {
+            volume *= 2 * r.h[i];
+        }
+        double i7 = volume * (w[0] * f1 + w[1] * sum2 + w[2] * sum3 + w[3] * sum4 + w[4] * sum5);
+        double i5 = volume * (v[0] * f1 + v[1] * sum2 + v[2] * sum3 + v[3] * sum4);
+        r.value = i7;
+        r.error = std::abs(i7 - i5);
+    }
+};
+
+/**
+ * @brief 多元函数自适应Genz-Malik法求积分
+ * @param f 函数，double(const double*)或批量求值函数
+ * @param a 各维下界， b 各维上界，维度dim = a.size() >= 2
+ * @param pool 线程池，为nullptr时在当前线程求值
+ * @param eps 相对精度(积分值小于1时为绝对精度)
+ * @param max_eval 最大求值次数
+ * @note 每轮取出误差最大的若干个子区域(有线程池时为线程数个)，沿四阶差分最大的维度二分
+ *       所有新子区域的节点一次批量求值
+ */
+template <typename T>
+integral_t genz_malik(const T& f, const std::vector<double>& a, const std::vector<double>& b,
+    ThreadPool* pool, double eps = 1e-6, long long max_eval = 1 << 22)
+{
+    const int dim = a.size();
+#ifdef GXY_DEBUG
+    if (dim < 2 || dim > 20 || b.size() != a.size()) {
+        debug::cerr() << "genz_malik: dimension must be in [2, 20]\n";
+        throw std::runtime_error("genz_malik: dimension must be in [2, 20]");
+    }
+#endif
+    const genz_malik_rule rule(dim);
+    const int width = pool ? pool->size() : 1;
+    std::vector<double> x, y;
+    std::vector<region_t> batch;
+    integral_t res { 0, 0, 0 };
+
+    // 计算batch中所有子区域的积分
+    auto compute = [&]() {
+        const long long n = (long long)batch.size() * rule.points;
+        x.resize(n * dim), y.resize(n);
+        for (size_t k = 0; k < batch.size(); ++k) {
+            rule.nodes(batch[k], &x[k * rule.points * dim]);
+        }
+        evaluate_points(f, dim, x.data(), y.data(), n, pool);
+        for (size_t k = 0; k < batch.size(); ++k) {
+            rule.apply(batch[k], &y[k * rule.points]);
+        }
+        res.evals += n;
+    };
+
+    region_t root { std::vector<double>(dim), std::vector<double>(dim), 0, 0, 0 };
+    for (int i = 0; i < dim; ++i) {
+        root.c[i] = (a[i] + b[i]) / 2;
+        root.h[i] = (b[i] - a[i]) / 2;
+    }
+    batch.push_back(root);
+    compute();
+    std::priority_queue<region_t> heap;
+    heap.push(batch[0]);
+    res.value = batch[0].value, res.error = batch[0].error;
+    while (res.error > eps * std::max(1.0, std::abs(res.value)) && res.evals < max_eval) {
+        batch.clear();
+        for (int k = 0; k < width && !heap.empty(); ++k) {
+            region_t r = heap.top();
+            heap.pop();
+            res.value -= r.value, res.error -= r.error;
+            r.h[r.split] /= 2;
+            region_t l = r;
+            l.c[l.split] -= r.h[r.split];
+            r.c[r.split] += r.h[r.split];
+            batch.push_back(std::move(l));
+            batch.push_back(std::move(r));
+        }
+        compute();
+        for (auto& r : batch) {
+            res.value += r.value, res.error += r.error;
+            heap.push(std::move(r));
+        }
+    }
+    res.value = res.error = 0;
+    for (; !heap.empty(); heap.pop()) {
+        res.value += heap.top().value;
+        res.error += heap.top().error;
+    }
+    return res;
+}
+
+template <typename T>
+integral_t genz_malik(const T& f, const std::vector<double>& a, const std::vector<double>& b,
+    double eps = 1e-6, long long max_eval = 1 << 22)
+{
+    return genz_malik(f, a, b, nullptr, eps, max_eval);
+}
+
+template <typename T>
+integral_t genz_malik(const T& f, const std::vector<double>& a, const std::vector<double>& b,
+    ThreadPool& pool, double eps = 1e-6, long long max_eval = 1 << 22)
+{
+    return genz_malik(f, a, b, &pool, eps, max_eval);
+}
+
+/**
+ * @brief 加扰的Sobol序列
+ * @note 方向数取自Joe-Kuo(new-joe-kuo-6.21201)，最多支持21维
+ * @note 加扰方式为随机下三角矩阵(linear matrix scrambling)加随机数字移位
+ *       加扰后每个点仍是[0, 1)^dim上的(t, m, s)网，且点的分布是无偏的
+ */
+struct sobol_t {
+    static constexpr int MAXDIM = 21;
+    static constexpr int BITS = 32;
+    int dim;
+    std::vector<unsigned int> v; // v[j * BITS + k]为第j维第k个方向数
+    std::vector<unsigned int> shift;
+
+    sobol_t(int dim, random_t& rnd)
+        : dim(dim)
+        , v(dim * BITS)
+        , shift(dim)
+    {
+        static const int s[MAXDIM] = { 0, 1, 2, 3, 3, 4, 4, 5, 5, 5, 5, 5, 5, 6, 6, 6, 6, 6, 6, 7, 7 };
+        static const int a[MAXDIM] = { 0, 0, 1, 1, 2, 1, 4, 2, 4, 7, 11, 13, 14, 1, 13, 16, 19, 22, 25, 1, 4 };
+        static const int m[MAXDIM][7] = { {}, { 1 }, { 1, 3 }, { 1, 3, 1 }, { 1, 1, 1 }, { 1, 1, 3, 3 },
+            { 1, 3, 5, 13 }, { 1, 1, 5, 5, 17 }, { 1, 1, 5, 5, 5 }, { 1, 1, 7, 11, 19 }, { 1, 1, 5, 1, 1 },
+            { 1, 1, 1, 3, 11 }, { 1, 3, 5, 5, 31 }, { 1, 3, 3, 9, 7, 49 }, { 1, 1, 1, 15, 21, 21 },
+            { 1, 3, 1, 13, 27, 49 }, { 1, 1, 1, 15, 7, 5 }, { 1, 3, 1, 15, 13, 25 }, { 1, 1, 5, 5, 19, 61 },
+            { 1, 3, 7, 11, 23, 15, 103 }, { 1, 3, 7, 13, 13, 15, 69 } };
+#ifdef GXY_DEBUG
+        if (dim < 1 || dim > MAXDIM) {
+            debug::cerr() << "sobol_t: dimension must be in [1, 21]\n";
+            throw std::runtime_error("sobol_t: dimension must be in [1, 21]");
+        }
+#endif
+        for (int j = 0; j < dim; ++j) {
+            unsigned int* d = &v[j * BITS];
+            if (j == 0) {
+                for (int k = 0; k < BITS; ++k) {
+                    d[k] = 1u << (BITS - 1 - k);
+                }
+            } else {
+                for (int k = 0; k < s[j]; ++k) {
+                    d[k] = (unsigned int)m[j][k] << (BITS - 1 - k);
+                }
+                for (int k = s[j]; k < BITS; ++k) {
+                    d[k] = d[k - s[j]] ^ (d[k - s[j]] >> s[j]);
+                    for (int l = 1; l < s[j]; ++l) {
+                        if (a[j] >> (s[j] - 1 - l) & 1) {
+                            d[k] ^= d[k - l];
+                        }
+                    }
+                }
+            }
+            // 下三角矩阵左乘每个方向数：输出的第r高位 = 输入的第r高位 xor 随机选取的更高位
+            unsigned int row[BITS];
+            for (int r = 0; r < BITS; ++r) {
+                unsigned int above = r == 0 ? 0 : (unsigned int)rnd.next(1LL << r) << (BITS - r);
+                row[r] = above | (1u << (BITS - 1 - r));
+            }
+            for (int k = 0; k < BITS; ++k) {
+                unsigned int scrambled = 0;
+                for (int r = 0; r < BITS; ++r) {
+                    scrambled |= (unsigned int)__builtin_parity(d[k] & row[r]) << (BITS - 1 - r);
+                }
+                d[k] = scrambled;
+            }
+            shift[j] = (unsigned int)rnd.next(1LL << BITS);
+        }
+    }
+
+    /**
+     * @brief 写出第first到first + n - 1个点，x为n * dim个坐标
+     * @note 按Gray码顺序生成，前2^m个点与标准顺序是同一个点集
+     */
+    void points(long long first, int n, double* x) const
+    {
+        std::vector<unsigned int> state(dim);
+        long long gray = first ^ (first >> 1);
+        for (int j = 0; j < dim; ++j) {
+            state[j] = shift[j];
+            for (int k = 0; k < BITS; ++k) {
+                if (gray >> k & 1) {
+                    state[j] ^= v[j * BITS + k];
+                }
+            }
+        }
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < dim; ++j) {
+                x[i * dim + j] = (state[j] + 0.5) / 4294967296.0;
+            }
+            const int c = __builtin_ctzll(first + i + 1);
+            for (int j = 0; j < dim; ++j) {
+                state[j] ^= v[j * BITS + c];
+            }
+        }
+    }
+};
+
+/**
+ * @brief 多元函数拟蒙特卡洛法求积分
+ * @param f 函数，double(const double*)或批量求值函数
+ * @param a 各维下界， b 各维上界，维度dim = a.size() <= 21
+ * @param pool 线程池，为nullptr时在当前线程求值
+ * @param n 每组的点数，取2的幂时效果最好
+ * @param replicates 独立加扰的组数，误差估计为各组结果的标准误差
+ * @param seed 加扰的随机种子
+ * @note 点分块生成，内存与n无关；各块按顺序累加，结果与线程调度无关
+ */
+template <typename T>
+integral_t sobol_qmc(const T& f, const std::vector<double>& a, const std::vector<double>& b,
+    ThreadPool* pool, long long n = 1 << 16, int replicates = 8, long long seed = 20241105)
+{
+    constexpr long long BLOCK = 4096;
+    const int dim = a.size();
+    random_t rnd;
+    rnd.setSeed(seed);
+    double volume = 1;
+    for (int j = 0; j < dim; ++j) {
+        volume *= b[j] - a[j];
+    }
+    const long long blocks = (n + BLOCK - 1) / BLOCK;
+    std::vector<double> partial(blocks), estimate(replicates);
+    for (int r = 0; r < replicates; ++r) {
+        const sobol_t sobol(dim, rnd);
+        auto run = [&](size_t lo, size_t hi) {
+            std::vector<double> x(EVAL_BATCH * dim), y(EVAL_BATCH);
+            for (size_t blk = lo; blk < hi; ++blk) {
+                partial[blk] = 0;
+                const long long end = std::min(n, (long long)(blk + 1) * BLOCK);
+                for (long long i = blk * BLOCK; i < end; i += EVAL_BATCH) {
+                    const int m = std::min<long long>(EVAL_BATCH, end - i);
+                    sobol.points(i, m, x.data());
+                    for (int k = 0; k < m * dim; ++k) {
+                        x[k] = a[k % dim] + x[k] * (b[k % dim] - a[k % dim]);
+                    }
+                    evaluate_points(f, dim, x.data(), y.data(), m, nullptr);
+                    for (int k = 0; k < m; ++k) {
+                        partial[blk] += y[k];
+                    }
+                }
+            }
+        };
+        if (pool) {
+            parallel_for(*pool, 0, blocks, run, 1);
+        } else {
+            run(0, blocks);
+        }
+        double sum = 0;
+        for (double p : partial) {
+            sum += p;
+        }
+        estimate[r] = volume * sum / n;
+    }
+    integral_t res { 0, 0, n * replicates };
+    for (double e : estimate) {
+        res.value += e;
+    }
+    res.value /= replicates;
+    if (replicates > 1) {
+        double var = 0;
+        for (double e : estimate) {
+            var += (e - res.value) * (e - res.value);
+        }
+        res.error = std::sqrt(var / (replicates - 1) / replicates);
+    }
+    return res;
+}
+
+template <typename T>
+integral_t sobol_qmc(const T& f, const std::vector<double>& a, const std::vector<double>& b,
+    long long n = 1 << 16, int replicates = 8, long long seed = 20241105)
+{
+    return sobol_qmc(f, a, b, nullptr, n, replicates, seed);
+}
+
+template <typename T>
+integral_t sobol_qmc(const T& f, const std::vector<double>& a, const std::vector<double>& b,
+    ThreadPool& pool, long long n = 1 << 16, int replicates = 8, long long seed = 20241105)
+{
+    return sobol_qmc(f, a, b, &pool, n, replicates, seed);
+}
+} // namespace demath
+
+#endif // MY_DEMATH_CUBATURE_HPP
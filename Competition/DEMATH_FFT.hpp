@@ -0,0 +1,310 @@
+#ifndef MY_DEMATH_FFT_HPP
+#define MY_DEMATH_FFT_HPP
+/**
+ * @brief 快速傅里叶变换与多项式运算
+ *
+ * @brief 复数FFT fft, 实数卷积 convolve
+ * @brief 模998244353的数论变换 ntt (Montgomery模乘)
+ * @brief 多项式乘法 poly_multiply, 求逆 poly_inverse, 带余除法 poly_divide
+ *
+ * @note 迭代实现，单位根按层连续存放，第k层(k为2的幂)的单位根在roots[k, 2k)
+ *       蝴蝶运算按顺序访问单位根，对缓存友好
+ * @note 单位根表和补齐到2的幂的缓冲区放在线程局部的fft_pool_t中，只增长不释放，重复调用不再分配
+ * @note 结果是整数且不超过约2^50时，convolve四舍五入后是精确的；需要精确取模时用poly_multiply
+ *
+ * @example 使用示例
+ * int main()
+ * {
+ *     std::vector<double> c = demath::convolve({ 1, 2, 3 }, { 4, 5 }); // 4 13 22 15
+ *     std::vector<unsigned int> a = { 1, 1 }, b = { 1, 998244352 };
+ *     std::vector<unsigned int> d = demath::poly_multiply(a, b); // 1 - x^2
+ *     std::vector<unsigned int> inv = demath::poly_inverse(a, 4); // 1 - x + x^2 - x^3
+ *     return 0;
+ * }
+ */
+
+#include "DEMATH.hpp"
+#include "DEMATH_NUMBER.hpp"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+namespace demath {
+constexpr unsigned int NTT_MOD = 998244353; // 119 * 2^23 + 1
+constexpr unsigned int NTT_ROOT = 3; // 原根
+constexpr montgomery32_t NTT_MONT(NTT_MOD);
+
+/**
+ * @brief FFT/NTT的工作区池
+ * @note roots/ntt_roots为单位根表，cbuf/nbuf为补齐到2的幂的缓冲区
+ */
+struct fft_pool_t {
+    std::vector<std::complex<double>> roots { 1, 1 };
+    std::vector<unsigned int> ntt_roots { NTT_MONT.one(), NTT_MONT.one() };
+    std::vector<std::complex<double>> cbuf[2];
+    std::vector<unsigned int> nbuf[2];
+
+    static fft_pool_t& local()
+    {
+        thread_local fft_pool_t pool;
+        return pool;
+    }
+
+    /**
+     * @brief 保证单位根表覆盖长度n的变换，roots[k + j] = e^(iπj/k)
+     */
+    void reserve_roots(int n)
+    {
+        for (int k = roots.size(); k < n; k *= 2) {
+            roots.resize(2 * k);
+            for (int j = 0; j < k; ++j) {
+                const long double angle = acosl(-1) * j / k;
+                roots[k + j] = std::complex<double>(cosl(angle), sinl(angle));
+            }
+        }
+    }
+
+    /**
+     * @brief 保证NTT单位根表覆盖长度n的变换，ntt_roots[k + j] = w^j，w为2k次单位根
+     */
+    void reserve_ntt_roots(int n)
+    {
+        for (int k = ntt_roots.size(); k < n; k *= 2) {
+            ntt_roots.resize(2 * k);
+            const unsigned int w = NTT_MONT.pow(NTT_MONT.to(NTT_ROOT), (NTT_MOD - 1) / (2 * k));
+            for (int j = k; j < 2 * k; ++j) {
+                ntt_roots[j] = j & 1 ? NTT_MONT.mul(ntt_roots[j / 2], w) : ntt_roots[j / 2];
+            }
+        }
+    }
+};
+
+/**
+ * @brief 不小于n的最小的2的幂
+ */
+inline int ceil_pow2(int n)
+{
+    int k = 1;
+    while (k < n) {
+        k *= 2;
+    }
+    return k;
+}
+
+/**
+ * @brief 按位翻转下标重排，原地进行
+ */
+template <typename T>
+void bit_reverse(T* a, int n)
+{
+    for (int i = 1, j = 0; i < n; ++i) {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            std::swap(a[i], a[j]);
+        }
+    }
+}
+
+/**
+ * @brief 原地复数FFT a[k] = sum a[j] * e^(2πijk/n)
+ * @param n 长度，必须是2的幂
+ * @note 逆变换：把a[1..n-1]反转后再做一次，最后除以n
+ */
+inline void fft(std::complex<double>* a, int n, fft_pool_t& pool = fft_pool_t::local())
+{
+    pool.reserve_roots(n);
+    bit_reverse(a, n);
+    const std::complex<double>* rt = pool.roots.data();
+    for (int k = 1; k < n; k *= 2) {
+        for (int i = 0; i < n; i += 2 * k) {
+            for (int j = 0; j < k; ++j) {
+                // 手动展开复数乘法，避免std::complex对inf/nan的检查
+                const double* x = (const double*)&rt[j + k];
+                double* y = (double*)&a[i + j + k];
+                const std::complex<double> z(x[0] * y[0] - x[1] * y[1], x[0] * y[1] + x[1] * y[0]);
+                a[i + j + k] = a[i + j] - z;
+                a[i + j] += z;
+            }
+        }
+    }
+}
+
+/**
+ * @brief 实数卷积 c[k] = sum a[i] * b[k - i]
+ * @note 把a, b分别放在实部和虚部，只需两次FFT
+ */
+inline std::vector<double> convolve(const std::vector<double>& a, const std::vector<double>& b)
+{
+    if (a.empty() || b.empty()) {
+        return {};
+    }
+    std::vector<double> res(a.size() + b.size() - 1);
+    const int n = ceil_pow2(res.size());
+    fft_pool_t& pool = fft_pool_t::local();
+    std::vector<std::complex<double>>& in = pool.cbuf[0];
+    std::vector<std::complex<double>>& out = pool.cbuf[1];
+    in.assign(n, 0), out.resize(n);
+    for (size_t i = 0; i < a.size(); ++i) {
+        in[i].real(a[i]);
+    }
+    for (size_t i = 0; i < b.size(); ++i) {
+        in[i].imag(b[i]);
+    }
+    fft(in.data(), n, pool);
+    for (auto& x : in) {
+        x *= x;
+    }
+    // (A + iB)^2 = A^2 - B^2 + 2iAB，取共轭对称部分得到AB
+    for (int i = 0; i < n; ++i) {
+        out[i] = in[-i & (n - 1)] - std::conj(in[i]);
+    }
+    fft(out.data(), n, pool);
+    for (size_t i = 0; i < res.size(); ++i) {
+        res[i] = out[i].imag() / (4 * n);
+    }
+    return res;
+}
+
+/**
+ * @brief 原地数论变换，a为Montgomery形式
+ * @param n 长度，必须是2的幂且不超过2^23
+ * @param inverse 是否为逆变换(包含除以n)
+ */
+inline void ntt(unsigned int* a, int n, bool inverse = false, fft_pool_t& pool = fft_pool_t::local())
+{
+    pool.reserve_ntt_roots(n);
+    if (inverse) {
+        std::reverse(a + 1, a + n);
+    }
+    bit_reverse(a, n);
+    const unsigned int* rt = pool.ntt_roots.data();
+    for (int k = 1; k < n; k *= 2) {
+        for (int i = 0; i < n; i += 2 * k) {
+            for (int j = 0; j < k; ++j) {
+                const unsigned int z = NTT_MONT.mul(rt[j + k], a[i + j + k]);
+                a[i + j + k] = NTT_MONT.sub(a[i + j], z);
+                a[i + j] = NTT_MONT.add(a[i + j], z);
+            }
+        }
+    }
+    if (inverse) {
+        const unsigned int inv_n = NTT_MONT.to(NTT_MOD - (NTT_MOD - 1) / n);
+        for (int i = 0; i < n; ++i) {
+            a[i] = NTT_MONT.mul(a[i], inv_n);
+        }
+    }
+}
+
+/**
+ * @brief 模998244353的多项式乘法
+ * @param a, b 系数(普通形式，小于NTT_MOD)，a[i]为x^i的系数
+ * @note 较短的多项式不超过32项时直接O(nm)相乘
+ */
+inline std::vector<unsigned int> poly_multiply(const std::vector<unsigned int>& a, const std::vector<unsigned int>& b)
+{
+    if (a.empty() || b.empty()) {
+        return {};
+    }
+    std::vector<unsigned int> res(a.size() + b.size() - 1);
+    if (std::min(a.size(), b.size()) <= 32) {
+        for (size_t i = 0; i < a.size(); ++i) {
+            for (size_t j = 0; j < b.size(); ++j) {
+                res[i + j] = (res[i + j] + (unsigned long long)a[i] * b[j]) % NTT_MOD;
+            }
+        }
+        return res;
+    }
+    const int n = ceil_pow2(res.size());
+    fft_pool_t& pool = fft_pool_t::local();
+    std::vector<unsigned int>& fa = pool.nbuf[0];
+    std::vector<unsigned int>& fb = pool.nbuf[1];
+    fa.assign(n, 0), fb.assign(n, 0);
+    for (size_t i = 0; i < a.size(); ++i) {
+        fa[i] = NTT_MONT.to(a[i]);
+    }
+    for (size_t i = 0; i < b.size(); ++i) {
+        fb[i] = NTT_MONT.to(b[i]);
+    }
+    ntt(fa.data(), n, false, pool);
+    ntt(fb.data(), n, false, pool);
+    for (int i = 0; i < n; ++i) {
+        fa[i] = NTT_MONT.mul(fa[i], fb[i]);
+    }
+    ntt(fa.data(), n, true, pool);
+    for (size_t i = 0; i < res.size(); ++i) {
+        res[i] = NTT_MONT.from(fa[i]);
+    }
+    return res;
+}
+
+/**
+ * @brief 模998244353的多项式求逆，求g使得a * g = 1 (mod x^n)
+ * @param a 系数，要求a[0] != 0
+ * @note 牛顿迭代 g = g * (2 - a * g)，每次精度翻倍，时间复杂度O(n log n)
+ */
+inline std::vector<unsigned int> poly_inverse(const std::vector<unsigned int>& a, int n)
+{
+    fft_pool_t& pool = fft_pool_t::local();
+    std::vector<unsigned int>& fa = pool.nbuf[0];
+    std::vector<unsigned int>& fg = pool.nbuf[1];
+    std::vector<unsigned int> g = { NTT_MONT.pow(NTT_MONT.to(a[0]), NTT_MOD - 2) }; // Montgomery形式
+    const unsigned int two = NTT_MONT.to(2);
+    for (int k = 1; k < n; k *= 2) {
+        // 已知g mod x^k，求g mod x^2k；a取前2k项，a * g * g的次数小于4k
+        const int m = 4 * k;
+        fa.assign(m, 0), fg.assign(m, 0);
+        for (int i = 0; i < 2 * k && i < (int)a.size(); ++i) {
+            fa[i] = NTT_MONT.to(a[i]);
+        }
+        std::copy(g.begin(), g.end(), fg.begin());
+        ntt(fa.data(), m, false, pool);
+        ntt(fg.data(), m, false, pool);
+        for (int i = 0; i < m; ++i) {
+            fa[i] = NTT_MONT.mul(fg[i], NTT_MONT.sub(two, NTT_MONT.mul(fa[i], fg[i])));
+        }
+        ntt(fa.data(), m, true, pool);
+        g.assign(fa.begin(), fa.begin() + 2 * k);
+    }
+    g.resize(n);
+    for (auto& x : g) {
+        x = NTT_MONT.from(x);
+    }
+    return g;
+}
+
+/**
+ * @brief 模998244353的多项式带余除法 a = b * q + r，deg(r) < deg(b)
+ * @param b 除式，最高次项系数不能为0
+ * @note 反转系数后商等于rev(a) * rev(b)^-1 (mod x^(n-m+1))，时间复杂度O(n log n)
+ */
+inline void poly_divide(const std::vector<unsigned int>& a, const std::vector<unsigned int>& b,
+    std::vector<unsigned int>& q, std::vector<unsigned int>& r)
+{
+    const int n = a.size(), m = b.size();
+    if (n < m) {
+        q.clear();
+        r = a;
+        return;
+    }
+    const int k = n - m + 1;
+    std::vector<unsigned int> ra(a.rbegin(), a.rbegin() + k), rb(b.rbegin(), b.rend());
+    q = poly_multiply(ra, poly_inverse(rb, k));
+    q.resize(k);
+    std::reverse(q.begin(), q.end());
+    std::vector<unsigned int> bq = poly_multiply(b, q);
+    r.resize(m - 1);
+    for (int i = 0; i < m - 1; ++i) {
+        r[i] = (a[i] + NTT_MOD - bq[i]) % NTT_MOD;
+    }
+    while (!r.empty() && r.back() == 0) {
+        r.pop_back();
+    }
+}
+} // namespace demath
+
+#endif // MY_DEMATH_FFT_HPP
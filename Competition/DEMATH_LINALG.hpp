@@ -0,0 +1,410 @@
+#ifndef MY_DEMATH_LINALG_HPP
+#define MY_DEMATH_LINALG_HPP
+/**
+ * @brief 稠密线性代数
+ *
+ * @brief 行优先、64字节对齐的矩阵 matrix_t
+ * @brief 矩阵乘法 gemm (分块 + 打包 + 寄存器分块的微内核，可以多线程)
+ * @brief 矩阵向量乘法 gemv
+ * @brief LU分解 lu_t (部分主元)，Cholesky分解 cholesky_t (对称正定)，用于解线性方程组
+ *
+ * @note 在编译时加上 -mavx2 -mfma (或 -march=native) 可以启用AVX2/FMA微内核，否则使用可移植的标量微内核
+ * @note 与朴素三重循环的性能对比见 Competition2/2_matrix.cpp
+ *
+ * @example 使用示例
+ * int main()
+ * {
+ *     demath::matrix_t a(512, 512), b(512, 512), c(512, 512);
+ *     ThreadPool pool(8);
+ *     demath::gemm(a, b, c, pool); // c = a * b
+ *     demath::lu_t lu(a);
+ *     std::vector<double> x = lu.solve(std::vector<double>(512, 1.0));
+ *     return 0;
+ * }
+ */
+
+#include "DEMATH.hpp"
+#include <algorithm>
+#include <cmath>
+#include <new>
+#include <vector>
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#endif
+
+namespace demath {
+/**
+ * @brief 按A字节对齐分配内存的分配器
+ */
+template <typename T, size_t A>
+struct aligned_allocator {
+    using value_type = T;
+    template <typename U>
+    struct rebind {
+        using other = aligned_allocator<U, A>;
+    };
+    aligned_allocator() = default;
+    template <typename U>
+    aligned_allocator(const aligned_allocator<U, A>&) { }
+    T* allocate(size_t n) { return (T*)::operator new(n * sizeof(T), std::align_val_t(A)); }
+    void deallocate(T* p, size_t) { ::operator delete(p, std::align_val_t(A)); }
+    bool operator==(const aligned_allocator&) const { return true; }
+    bool operator!=(const aligned_allocator&) const { return false; }
+};
+
+using aligned_vector = std::vector<double, aligned_allocator<double, 64>>;
+
+/**
+ * @brief 行优先存储的稠密矩阵，a[i][j]为第i行第j列
+ */
+struct matrix_t {
+    int rows, cols;
+    aligned_vector data;
+
+    matrix_t(int rows = 0, int cols = 0, double value = 0)
+        : rows(rows)
+        , cols(cols)
+        , data((size_t)rows * cols, value)
+    {
+    }
+
+    double* operator[](int i) { return &data[(size_t)i * cols]; }
+    const double* operator[](int i) const { return &data[(size_t)i * cols]; }
+
+    static matrix_t identity(int n)
+    {
+        matrix_t a(n, n);
+        for (int i = 0; i < n; ++i) {
+            a[i][i] = 1;
+        }
+        return a;
+    }
+};
+
+constexpr int GEMM_MR = 4; // 微内核的行数
+constexpr int GEMM_NR = 8; // 微内核的列数
+constexpr int GEMM_KC = 256; // B的一条MR x KC切片约16KB，放在L1中
+constexpr int GEMM_MC = 96; // A的一块MC x KC约192KB，放在L2中
+constexpr int GEMM_NC = 4096; // B的一块KC x NC放在L3中
+
+/**
+ * @brief 微内核 c[0..MR)[0..NR) += a * b
+ * @param a 打包后的A切片，每个k连续存放MR个数
+ * @param b 打包后的B切片，每个k连续存放NR个数，32字节对齐
+ */
+inline void gemm_kernel(int kc, const double* a, const double* b, double* c, int ldc)
+{
+#if defined(__AVX2__) && defined(__FMA__)
+    __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+    __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+    __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+    __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+    for (int p = 0; p < kc; ++p, a += GEMM_MR, b += GEMM_NR) {
+        const __m256d b0 = _mm256_load_pd(b), b1 = _mm256_load_pd(b + 4);
+        __m256d x = _mm256_broadcast_sd(a);
+        c00 = _mm256_fmadd_pd(x, b0, c00), c01 = _mm256_fmadd_pd(x, b1, c01);
+        x = _mm256_broadcast_sd(a + 1);
+        c10 = _mm256_fmadd_pd(x, b0, c10), c11 = _mm256_fmadd_pd(x, b1, c11);
+        x = _mm256_broadcast_sd(a + 2);
+        c20 = _mm256_fmadd_pd(x, b0, c20), c21 = _mm256_fmadd_pd(x, b1, c21);
+        x = _mm256_broadcast_sd(a + 3);
+        c30 = _mm256_fmadd_pd(x, b0, c30), c31 = _mm256_fmadd_pd(x, b1, c31);
+    }
+    auto store = [](double* row, __m256d lo, __m256d hi) {
+        _mm256_storeu_pd(row, _mm256_add_pd(_mm256_loadu_pd(row), lo));
+        _mm256_storeu_pd(row + 4, _mm256_add_pd(_mm256_loadu_pd(row + 4), hi));
+    };
+    store(c, c00, c01);
+    store(c + ldc, c10, c11);
+    store(c + 2 * ldc, c20, c21);
+    store(c + 3 * ldc, c30, c31);
+#else
+    double acc[GEMM_MR][GEMM_NR] = {};
+    for (int p = 0; p < kc; ++p, a += GEMM_MR, b += GEMM_NR) {
+        for (int r = 0; r < GEMM_MR; ++r) {
+            for (int j = 0; j < GEMM_NR; ++j) {
+                acc[r][j] += a[r] * b[j];
+            }
+        }
+    }
+    for (int r = 0; r < GEMM_MR; ++r) {
+        for (int j = 0; j < GEMM_NR; ++j) {
+            c[r * ldc + j] += acc[r][j];
+        }
+    }
+#endif
+}
+
+/**
+ * @brief 打包A的mc x kc块，乘上alpha，按MR行一条切片存放，不足的行补0
+ */
+inline void gemm_pack_a(int mc, int kc, double alpha, const double* a, int lda, double* pack)
+{
+    for (int i = 0; i < mc; i += GEMM_MR) {
+        for (int p = 0; p < kc; ++p) {
+            for (int r = 0; r < GEMM_MR; ++r) {
+                *pack++ = i + r < mc ? alpha * a[(size_t)(i + r) * lda + p] : 0;
+            }
+        }
+    }
+}
+
+/**
+ * @brief 打包B的kc x nc块，按NR列一条切片存放，不足的列补0
+ */
+inline void gemm_pack_b(int kc, int nc, const double* b, int ldb, double* pack)
+{
+    for (int j = 0; j < nc; j += GEMM_NR) {
+        const int w = std::min(GEMM_NR, nc - j);
+        for (int p = 0; p < kc; ++p) {
+            const double* row = b + (size_t)p * ldb + j;
+            for (int c = 0; c < GEMM_NR; ++c) {
+                *pack++ = c < w ? row[c] : 0;
+            }
+        }
+    }
+}
+
+/**
+ * @brief 通用矩阵乘法 C = alpha * A * B + beta * C，A为m x k，B为k x n，C为m x n，均为行优先
+ * @param lda, ldb, ldc 每行的跨度
+ * @param pool 线程池，为nullptr时在当前线程计算；有线程池时按C的行块并行
+ * @note 按GotoBLAS的方式分块：B的KC x NC块打包后被所有行块共享，A的MC x KC块打包到线程局部缓冲区
+ */
+inline void gemm(int m, int n, int k, double alpha, const double* a, int lda, const double* b, int ldb,
+    double beta, double* c, int ldc, ThreadPool* pool = nullptr)
+{
+    if (beta != 1) {
+        for (int i = 0; i < m; ++i) {
+            double* row = c + (size_t)i * ldc;
+            for (int j = 0; j < n; ++j) {
+                row[j] = beta == 0 ? 0 : row[j] * beta;
+            }
+        }
+    }
+    if (alpha == 0 || k == 0) {
+        return;
+    }
+    aligned_vector bpack;
+    for (int jc = 0; jc < n; jc += GEMM_NC) {
+        const int nc = std::min(GEMM_NC, n - jc);
+        for (int pc = 0; pc < k; pc += GEMM_KC) {
+            const int kc = std::min(GEMM_KC, k - pc);
+            bpack.resize((size_t)kc * ((nc + GEMM_NR - 1) / GEMM_NR * GEMM_NR));
+            gemm_pack_b(kc, nc, b + (size_t)pc * ldb + jc, ldb, bpack.data());
+            auto block = [&](size_t lo, size_t hi) {
+                thread_local aligned_vector apack;
+                apack.resize((size_t)kc * (GEMM_MC + GEMM_MR));
+                double tile[GEMM_MR * GEMM_NR];
+                for (size_t blk = lo; blk < hi; ++blk) {
+                    const int ic = blk * GEMM_MC, mc = std::min(GEMM_MC, m - ic);
+                    gemm_pack_a(mc, kc, alpha, a + (size_t)ic * lda + pc, lda, apack.data());
+                    for (int jr = 0; jr < nc; jr += GEMM_NR) {
+                        const double* bp = bpack.data() + (size_t)jr * kc;
+                        const int w = std::min(GEMM_NR, nc - jr);
+                        for (int ir = 0; ir < mc; ir += GEMM_MR) {
+                            const double* ap = apack.data() + (size_t)ir * kc;
+                            const int h = std::min(GEMM_MR, mc - ir);
+                            double* ct = c + (size_t)(ic + ir) * ldc + jc + jr;
+                            if (h == GEMM_MR && w == GEMM_NR) {
+                                gemm_kernel(kc, ap, bp, ct, ldc);
+                                continue;
+                            }
+                            // 边缘的不完整块先算到临时块中
+                            std::fill(tile, tile + GEMM_MR * GEMM_NR, 0);
+                            gemm_kernel(kc, ap, bp, tile, GEMM_NR);
+                            for (int r = 0; r < h; ++r) {
+                                for (int j = 0; j < w; ++j) {
+                                    ct[(size_t)r * ldc + j] += tile[r * GEMM_NR + j];
+                                }
+                            }
+                        }
+                    }
+                }
+            };
+            const size_t blocks = (m + GEMM_MC - 1) / GEMM_MC;
+            if (pool) {
+                parallel_for(*pool, 0, blocks, block, 1);
+            } else {
+                block(0, blocks);
+            }
+        }
+    }
+}
+
+/**
+ * @brief 矩阵乘法 c = alpha * a * b + beta * c
+ */
+inline void gemm(const matrix_t& a, const matrix_t& b, matrix_t& c, double alpha = 1, double beta = 0)
+{
+    gemm(a.rows, b.cols, a.cols, alpha, a.data.data(), a.cols, b.data.data(), b.cols, beta, c.data.data(), c.cols);
+}
+
+/**
+ * @brief 多线程矩阵乘法 c = alpha * a * b + beta * c
+ */
+inline void gemm(const matrix_t& a, const matrix_t& b, matrix_t& c, ThreadPool& pool, double alpha = 1, double beta = 0)
+{
+    gemm(a.rows, b.cols, a.cols, alpha, a.data.data(), a.cols, b.data.data(), b.cols, beta, c.data.data(), c.cols, &pool);
+}
+
+/**
+ * @brief 两个向量的内积，4路独立累加以隐藏浮点加法的延迟
+ */
+inline double dot4(const double* x, const double* y, int n)
+{
+    double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += x[i] * y[i];
+        s1 += x[i + 1] * y[i + 1];
+        s2 += x[i + 2] * y[i + 2];
+        s3 += x[i + 3] * y[i + 3];
+    }
+    for (; i < n; ++i) {
+        s0 += x[i] * y[i];
+    }
+    return (s0 + s1) + (s2 + s3);
+}
+
+/**
+ * @brief 矩阵向量乘法 y = alpha * a * x + beta * y
+ */
+inline void gemv(const matrix_t& a, const double* x, double* y, double alpha = 1, double beta = 0)
+{
+    for (int i = 0; i < a.rows; ++i) {
+        const double v = alpha * dot4(a[i], x, a.cols);
+        y[i] = beta == 0 ? v : v + beta * y[i];
+    }
+}
+
+inline std::vector<double> gemv(const matrix_t& a, const std::vector<double>& x)
+{
+    std::vector<double> y(a.rows);
+    gemv(a, x.data(), y.data());
+    return y;
+}
+
+/**
+ * @brief 部分主元LU分解 PA = LU
+ * @note L的对角线为1不存储，L和U共用一个矩阵；行交换记录在piv中
+ * @note 时间复杂度O(n^3)，消元时按行做axpy，访问连续内存
+ */
+struct lu_t {
+    matrix_t lu;
+    std::vector<int> piv; // 第i步与第piv[i]行交换
+    bool singular;
+
+    lu_t(const matrix_t& a)
+        : lu(a)
+        , piv(a.rows)
+        , singular(false)
+    {
+        const int n = lu.rows;
+        for (int k = 0; k < n; ++k) {
+            int p = k;
+            for (int i = k + 1; i < n; ++i) {
+                if (std::abs(lu[i][k]) > std::abs(lu[p][k])) {
+                    p = i;
+                }
+            }
+            piv[k] = p;
+            if (p != k) {
+                std::swap_ranges(lu[k], lu[k] + n, lu[p]);
+            }
+            if (lu[k][k] == 0) {
+                singular = true;
+                continue;
+            }
+            const double inv = 1 / lu[k][k];
+            const double* uk = lu[k];
+            for (int i = k + 1; i < n; ++i) {
+                double* row = lu[i];
+                const double l = row[k] *= inv;
+                for (int j = k + 1; j < n; ++j) {
+                    row[j] -= l * uk[j];
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief 解Ax = b
+     */
+    std::vector<double> solve(std::vector<double> b) const
+    {
+        const int n = lu.rows;
+        for (int k = 0; k < n; ++k) {
+            std::swap(b[k], b[piv[k]]);
+        }
+        for (int i = 0; i < n; ++i) {
+            b[i] -= dot4(lu[i], b.data(), i);
+        }
+        for (int i = n - 1; i >= 0; --i) {
+            b[i] = (b[i] - dot4(lu[i] + i + 1, b.data() + i + 1, n - i - 1)) / lu[i][i];
+        }
+        return b;
+    }
+
+    double determinant() const
+    {
+        double det = 1;
+        for (int i = 0; i < lu.rows; ++i) {
+            det *= piv[i] == i ? lu[i][i] : -lu[i][i];
+        }
+        return det;
+    }
+};
+
+/**
+ * @brief Cholesky分解 A = LL^T，A为对称正定矩阵
+ * @note 只读取A的下三角；A不是正定矩阵时ok为false
+ * @note 计算量约为LU分解的一半
+ */
+struct cholesky_t {
+    matrix_t l;
+    bool ok;
+
+    cholesky_t(const matrix_t& a)
+        : l(a.rows, a.rows)
+        , ok(true)
+    {
+        const int n = a.rows;
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j <= i; ++j) {
+                const double s = a[i][j] - dot4(l[i], l[j], j);
+                if (i == j) {
+                    if (s <= 0) {
+                        ok = false;
+                        return;
+                    }
+                    l[i][i] = std::sqrt(s);
+                } else {
+                    l[i][j] = s / l[j][j];
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief 解Ax = b
+     */
+    std::vector<double> solve(std::vector<double> b) const
+    {
+        const int n = l.rows;
+        for (int i = 0; i < n; ++i) {
+            b[i] = (b[i] - dot4(l[i], b.data(), i)) / l[i][i];
+        }
+        for (int i = n - 1; i >= 0; --i) {
+            double s = b[i];
+            for (int j = i + 1; j < n; ++j) {
+                s -= l[j][i] * b[j];
+            }
+            b[i] = s / l[i][i];
+        }
+        return b;
+    }
+};
+} // namespace demath
+
+#endif // MY_DEMATH_LINALG_HPP
@@ -0,0 +1,323 @@
+#ifndef MY_DEMATH_NUMBER_HPP
+#define MY_DEMATH_NUMBER_HPP
+/**
+ * @brief 数论：64位模运算
+ *
+ * @brief 模乘、快速幂、逆元 mul_mod, pow_mod, inverse_mod
+ * @brief Montgomery模乘 montgomery_t (64位奇数模数，没有除法)，montgomery32_t (32位)
+ * @brief Barrett模乘 barrett_t (小于2^31的任意模数，没有除法)
+ * @brief 批量求逆元 batch_inverse (前缀积，n个逆元只需一次求逆)
+ *
+ * @note mul_mod、pow_mod、inverse_mod和montgomery_t、montgomery32_t、barrett_t的成员函数都是constexpr，可以在编译期求值；
+ *       batch_inverse使用临时内存，只能在运行期调用
+ *
+ * @example 使用示例
+ * int main()
+ * {
+ *     constexpr demath::montgomery_t mont(1000000007);
+ *     unsigned long long a = mont.to(12345), b = mont.to(67890);
+ *     unsigned long long c = mont.from(mont.mul(a, b)); // 12345 * 67890 % 1000000007
+ *     static_assert(demath::pow_mod(2, 10, 1000) == 24);
+ *
+ *     std::vector<unsigned long long> v = { 1, 2, 3, 4 }, inv(4);
+ *     demath::batch_inverse(v.data(), inv.data(), 4, 1000000007);
+ *     return 0;
+ * }
+ */
+
+#include "DEMATH.hpp"
+#include <vector>
+
+namespace demath {
+/**
+ * @brief 求a * b % m，中间结果用128位整数
+ */
+constexpr unsigned long long mul_mod(unsigned long long a, unsigned long long b, unsigned long long m)
+{
+    return (unsigned __int128)a * b % m;
+}
+
+/**
+ * @brief 快速幂求a^e % m
+ * @note 时间复杂度O(log(e))
+ */
+constexpr unsigned long long pow_mod(unsigned long long a, unsigned long long e, unsigned long long m)
+{
+    unsigned long long ans = 1 % m;
+    a %= m;
+    for (; e > 0; e >>= 1) {
+        if (e & 1) {
+            ans = mul_mod(ans, a, m);
+        }
+        a = mul_mod(a, a, m);
+    }
+    return ans;
+}
+
+/**
+ * @brief 求a在模m下的逆元
+ * @return 逆元，a与m不互质时返回0
+ */
+constexpr unsigned long long inverse_mod(unsigned long long a, unsigned long long m)
+{
+    __int128 x = 0, y = 0;
+    if (extend_gcd<__int128>(a % m, m, x, y) != 1) {
+        return 0;
+    }
+    return x < 0 ? x + m : x;
+}
+
+/**
+ * @brief Montgomery模乘
+ * @param mod 模数，必须是奇数
+ * @note 数x的Montgomery形式为x * 2^64 % mod，mul(a, b)得到a * b * 2^-64 % mod
+ *       用乘法和移位代替除法，适合模数在运行时才确定的大量模乘
+ * @note to/from在普通形式和Montgomery形式之间转换，mul/pow的参数和结果都是Montgomery形式
+ */
+struct montgomery_t {
+    unsigned long long mod;
+    unsigned long long inv; // mod * inv = 1 (mod 2^64)
+    unsigned long long r2; // 2^128 % mod
+
+    constexpr montgomery_t(unsigned long long mod)
+        : mod(mod)
+        , inv(mod)
+        , r2((unsigned long long)(-(unsigned __int128)mod % mod))
+    {
+        // 牛顿迭代，每次有效位数翻倍，mod * mod = 1 (mod 8)已有3位
+        for (int i = 0; i < 5; ++i) {
+            inv *= 2 - mod * inv;
+        }
+    }
+
+    /**
+     * @brief 求t * 2^-64 % mod，要求t < mod * 2^64
+     * @note t - m * mod的低64位为0，因此只需比较高64位
+     */
+    constexpr unsigned long long reduce(unsigned __int128 t) const
+    {
+        unsigned long long m = (unsigned long long)t * inv;
+        unsigned long long hi = t >> 64;
+        unsigned long long mn = ((unsigned __int128)m * mod) >> 64;
+        return hi >= mn ? hi - mn : hi - mn + mod;
+    }
+
+    constexpr unsigned long long mul(unsigned long long a, unsigned long long b) const
+    {
+        return reduce((unsigned __int128)a * b);
+    }
+
+    constexpr unsigned long long to(unsigned long long a) const
+    {
+        return mul(a % mod, r2);
+    }
+
+    constexpr unsigned long long from(unsigned long long a) const
+    {
+        return reduce(a);
+    }
+
+    constexpr unsigned long long one() const
+    {
+        return to(1);
+    }
+
+    constexpr unsigned long long add(unsigned long long a, unsigned long long b) const
+    {
+        return a >= mod - b ? a - (mod - b) : a + b;
+    }
+
+    constexpr unsigned long long sub(unsigned long long a, unsigned long long b) const
+    {
+        return a >= b ? a - b : a + (mod - b);
+    }
+
+    constexpr unsigned long long pow(unsigned long long a, unsigned long long e) const
+    {
+        unsigned long long ans = one();
+        for (; e > 0; e >>= 1) {
+            if (e & 1) {
+                ans = mul(ans, a);
+            }
+            a = mul(a, a);
+        }
+        return ans;
+    }
+
+    /**
+     * @brief 普通形式的a^e % mod
+     */
+    constexpr unsigned long long pow_mod(unsigned long long a, unsigned long long e) const
+    {
+        return from(pow(to(a), e));
+    }
+};
+
+/**
+ * @brief 32位Montgomery模乘
+ * @param mod 模数，必须是小于2^31的奇数
+ * @note 与montgomery_t相同，但R = 2^32，只需64位乘法，适合NTT等模数较小的场景
+ */
+struct montgomery32_t {
+    unsigned int mod;
+    unsigned int inv; // mod * inv = 1 (mod 2^32)
+    unsigned int r2; // 2^64 % mod
+
+    constexpr montgomery32_t(unsigned int mod)
+        : mod(mod)
+        , inv(mod)
+        , r2((unsigned int)(-(unsigned long long)mod % mod))
+    {
+        for (int i = 0; i < 4; ++i) {
+            inv *= 2 - mod * inv;
+        }
+    }
+
+    constexpr unsigned int reduce(unsigned long long t) const
+    {
+        unsigned int m = (unsigned int)t * inv;
+        unsigned int hi = t >> 32;
+        unsigned int mn = ((unsigned long long)m * mod) >> 32;
+        return hi >= mn ? hi - mn : hi - mn + mod;
+    }
+
+    constexpr unsigned int mul(unsigned int a, unsigned int b) const
+    {
+        return reduce((unsigned long long)a * b);
+    }
+
+    constexpr unsigned int to(unsigned int a) const
+    {
+        return mul(a % mod, r2);
+    }
+
+    constexpr unsigned int from(unsigned int a) const
+    {
+        return reduce(a);
+    }
+
+    constexpr unsigned int one() const
+    {
+        return to(1);
+    }
+
+    constexpr unsigned int add(unsigned int a, unsigned int b) const
+    {
+        return a >= mod - b ? a - (mod - b) : a + b;
+    }
+
+    constexpr unsigned int sub(unsigned int a, unsigned int b) const
+    {
+        return a >= b ? a - b : a + (mod - b);
+    }
+
+    constexpr unsigned int pow(unsigned int a, unsigned long long e) const
+    {
+        unsigned int ans = one();
+        for (; e > 0; e >>= 1) {
+            if (e & 1) {
+                ans = mul(ans, a);
+            }
+            a = mul(a, a);
+        }
+        return ans;
+    }
+};
+
+/**
+ * @brief Barrett模乘
+ * @param mod 模数，1 <= mod < 2^31
+ * @note 预先计算im = ceil(2^64 / mod)，用乘法和移位估计商，最多差1
+ * @note 参数和结果都是普通形式，要求参数小于mod
+ */
+struct barrett_t {
+    unsigned int mod;
+    unsigned long long im;
+
+    constexpr barrett_t(unsigned int mod)
+        : mod(mod)
+        , im(~0ULL / mod + 1)
+    {
+    }
+
+    constexpr unsigned int reduce(unsigned long long z) const
+    {
+        unsigned long long x = ((unsigned __int128)z * im) >> 64;
+        unsigned int v = (unsigned int)(z - x * mod);
+        return mod <= v ? v + mod : v;
+    }
+
+    constexpr unsigned int mul(unsigned int a, unsigned int b) const
+    {
+        return reduce((unsigned long long)a * b);
+    }
+
+    constexpr unsigned int pow(unsigned int a, unsigned long long e) const
+    {
+        unsigned int ans = 1 % mod;
+        for (; e > 0; e >>= 1) {
+            if (e & 1) {
+                ans = mul(ans, a);
+            }
+            a = mul(a, a);
+        }
+        return ans;
+    }
+};
+
+/**
+ * @brief 批量求逆元 out[i] = a[i]^-1 % mod
+ * @param a 输入数组，每个元素都必须与mod互质
+ * @param out 输出数组，可以与a相同
+ * @param n 元素个数
+ * @param mod 模数
+ * @note 前缀积 p[i] = a[0] * ... * a[i]，只对p[n-1]求一次逆元，再从后往前推出每个逆元
+ *       共3(n-1)次模乘加一次求逆；模数为奇数时使用Montgomery模乘
+ */
+inline void batch_inverse(const unsigned long long* a, unsigned long long* out, int n, unsigned long long mod)
+{
+    if (n <= 0) {
+        return;
+    }
+    std::vector<unsigned long long> prefix(n);
+    if (mod & 1) {
+        const montgomery_t mont(mod);
+        prefix[0] = mont.to(a[0]);
+        for (int i = 1; i < n; ++i) {
+            prefix[i] = mont.mul(prefix[i - 1], mont.to(a[i]));
+        }
+        unsigned long long inv = mont.to(inverse_mod(mont.from(prefix[n - 1]), mod));
+        for (int i = n - 1; i > 0; --i) {
+            const unsigned long long ai = mont.to(a[i]);
+            out[i] = mont.from(mont.mul(inv, prefix[i - 1]));
+            inv = mont.mul(inv, ai);
+        }
+        out[0] = mont.from(inv);
+    } else {
+        prefix[0] = a[0] % mod;
+        for (int i = 1; i < n; ++i) {
+            prefix[i] = mul_mod(prefix[i - 1], a[i], mod);
+        }
+        unsigned long long inv = inverse_mod(prefix[n - 1], mod);
+        for (int i = n - 1; i > 0; --i) {
+            const unsigned long long ai = a[i] % mod;
+            out[i] = mul_mod(inv, prefix[i - 1], mod);
+            inv = mul_mod(inv, ai, mod);
+        }
+        out[0] = inv;
+    }
+}
+
+/**
+ * @brief 批量求逆元
+ * @return 与a等长的逆元数组
+ */
+inline std::vector<unsigned long long> batch_inverse(const std::vector<unsigned long long>& a, unsigned long long mod)
+{
+    std::vector<unsigned long long> out(a.size());
+    batch_inverse(a.data(), out.data(), a.size(), mod);
+    return out;
+}
+} // namespace demath
+
+#endif // MY_DEMATH_NUMBER_HPP
@@ -0,0 +1,376 @@
+#ifndef MY_DEMATH_OPTIMIZE_HPP
+#define MY_DEMATH_OPTIMIZE_HPP
+/**
+ * @brief 多元函数无约束最小化
+ *
+ * @brief 拟牛顿法 lbfgs_t (需要梯度，收敛快)
+ * @brief 单纯形法 nelder_mead_t (不需要梯度，适合低维、不光滑的目标函数)
+ *
+ * @note 所有工作数组在构造时按维度分配，minimize过程中不再分配内存，同一个对象可以反复使用
+ * @note lbfgs_t的目标函数形如 double fg(const std::vector<double>& x, std::vector<double>& g)
+ *       返回f(x)并把梯度写入g；没有手写梯度时用with_gradient(f)由自动微分求梯度
+ *
+ * @example 使用示例
+ * int main()
+ * {
+ *     auto rosenbrock = [](const auto& x) { auto a = x[1] - x[0] * x[0], b = 1 - x[0]; return 100 * a * a + b * b; };
+ *     std::vector<double> x = { -1.2, 1.0 };
+ *     demath::lbfgs_t solver(2);
+ *     demath::minimize_t r = solver.minimize(demath::with_gradient(rosenbrock), x);
+ *
+ *     std::vector<double> y = { -1.2, 1.0 };
+ *     demath::nelder_mead_t simplex(2);
+ *     simplex.minimize([&](const std::vector<double>& x) { return rosenbrock(x); }, y);
+ *     return 0;
+ * }
+ */
+
+#include "DEMATH.hpp"
+#include "DEMATH_AUTODIFF.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace demath {
+/**
+ * @brief 最小化的结果
+ * @param value 最小值， iterations 迭代次数， evals 目标函数求值次数， converged 是否满足收敛条件
+ */
+struct minimize_t {
+    double value;
+    int iterations;
+    long long evals;
+    bool converged;
+};
+
+/**
+ * @brief 由泛型函数f构造带梯度的目标函数，梯度由反向模式自动微分求得
+ */
+template <typename F>
+auto with_gradient(const F& f)
+{
+    return [f](const std::vector<double>& x, std::vector<double>& g) {
+        return gradient(f, x, g);
+    };
+}
+
+inline double dot(const double* a, const double* b, int n)
+{
+    double ans = 0;
+    for (int i = 0; i < n; ++i) {
+        ans += a[i] * b[i];
+    }
+    return ans;
+}
+
+/**
+ * @brief L-BFGS拟牛顿法
+ * @param n 维度
+ * @param m 保存的历史步数，通常取5~20
+ * @note 搜索方向由两轮循环递推得到，步长由满足强Wolfe条件的线搜索确定
+ */
+struct lbfgs_t {
+    int n, m;
+    std::vector<double> s, y; // 最近m步的位移和梯度差，环形存储，第i步在s[i * n]
+    std::vector<double> rho, alpha;
+    std::vector<double> g, d, x_new, g_new;
+    double c1 = 1e-4, c2 = 0.9; // Wolfe条件的参数
+    int max_line_search = 20;
+
+    lbfgs_t(int n, int m = 8)
+        : n(n)
+        , m(m)
+        , s(m * n)
+        , y(m * n)
+        , rho(m)
+        , alpha(m)
+        , g(n)
+        , d(n)
+        , x_new(n)
+        , g_new(n)
+    {
+    }
+
+    /**
+     * @brief 从x出发最小化，结果写回x
+     * @param fg 目标函数，返回f(x)并把梯度写入g
+     * @param eps 梯度无穷范数不超过eps时认为收敛
+     * @param max_iter 最大迭代次数
+     */
+    template <typename F>
+    minimize_t minimize(const F& fg, std::vector<double>& x, double eps = 1e-8, int max_iter = 1000)
+    {
+        minimize_t res { fg(x, g), 0, 1, false };
+        int head = 0, count = 0; // 环形缓冲区中最新一步的下一个位置和已保存的步数
+        for (; res.iterations < max_iter; ++res.iterations) {
+            double gmax = 0;
+            for (int i = 0; i < n; ++i) {
+                gmax = std::max(gmax, std::abs(g[i]));
+            }
+            if (gmax <= eps) {
+                res.converged = true;
+                break;
+            }
+            // 两轮循环：d = -H * g
+            std::copy(g.begin(), g.end(), d.begin());
+            for (int k = 0; k < count; ++k) {
+                const int i = (head - 1 - k + m) % m;
+                alpha[i] = rho[i] * dot(&s[i * n], d.data(), n);
+                for (int j = 0; j < n; ++j) {
+                    d[j] -= alpha[i] * y[i * n + j];
+                }
+            }
+            if (count > 0) {
+                const int i = (head - 1 + m) % m;
+                const double gamma = dot(&s[i * n], &y[i * n], n) / dot(&y[i * n], &y[i * n], n);
+                for (int j = 0; j < n; ++j) {
+                    d[j] *= gamma;
+                }
+            }
+            for (int k = count - 1; k >= 0; --k) {
+                const int i = (head - 1 - k + m) % m;
+                const double beta = rho[i] * dot(&y[i * n], d.data(), n);
+                for (int j = 0; j < n; ++j) {
+                    d[j] += s[i * n + j] * (alpha[i] - beta);
+                }
+            }
+            for (int j = 0; j < n; ++j) {
+                d[j] = -d[j];
+            }
+            double slope = dot(d.data(), g.data(), n);
+            if (slope >= 0) {
+                // 不是下降方向，丢弃历史退化为梯度下降
+                count = 0;
+                for (int j = 0; j < n; ++j) {
+                    d[j] = -g[j];
+                }
+                slope = -dot(g.data(), g.data(), n);
+            }
+            const double t0 = count == 0 ? std::min(1.0, 1 / std::sqrt(-slope)) : 1.0;
+            double f_new;
+            if (!line_search(fg, x, res.value, slope, t0, f_new, res.evals)) {
+                break;
+            }
+            // 记录位移和梯度差，曲率条件不满足时跳过以保持H正定
+            double* sk = &s[head * n];
+            double* yk = &y[head * n];
+            for (int j = 0; j < n; ++j) {
+                sk[j] = x_new[j] - x[j];
+                yk[j] = g_new[j] - g[j];
+            }
+            const double sy = dot(sk, yk, n);
+            if (sy > 1e-12 * dot(yk, yk, n)) {
+                rho[head] = 1 / sy;
+                head = (head + 1) % m;
+                count = std::min(count + 1, m);
+            }
+            const double decrease = res.value - f_new;
+            x.swap(x_new), g.swap(g_new);
+            res.value = f_new;
+            if (decrease <= 1e-15 * std::max(1.0, std::abs(f_new))) {
+                res.converged = true;
+                ++res.iterations;
+                break;
+            }
+        }
+        return res;
+    }
+
+    /**
+     * @brief 沿方向d做满足强Wolfe条件的线搜索，结果在x_new, g_new中
+     * @return 是否找到满足充分下降条件的步长
+     */
+    template <typename F>
+    bool line_search(const F& fg, const std::vector<double>& x, double f0, double slope0, double t,
+        double& f_new, long long& evals)
+    {
+        auto trial = [&](double t, double& dphi) {
+            for (int j = 0; j < n; ++j) {
+                x_new[j] = x[j] + t * d[j];
+            }
+            double f = fg(x_new, g_new);
+            ++evals;
+            dphi = dot(g_new.data(), d.data(), n);
+            return f;
+        };
+        double lo = 0, f_lo = f0, d_lo = slope0, hi = 0, f_hi = 0;
+        bool bracketed = false;
+        for (int k = 0; k < max_line_search; ++k) {
+            double dphi;
+            const double f = trial(t, dphi);
+            if (!bracketed) {
+                if (f > f0 + c1 * t * slope0 || (k > 0 && f >= f_lo)) {
+                    bracketed = true, hi = t, f_hi = f;
+                } else if (std::abs(dphi) <= -c2 * slope0) {
+                    f_new = f;
+                    return true;
+                } else if (dphi >= 0) {
+                    bracketed = true, hi = lo, f_hi = f_lo;
+                    lo = t, f_lo = f, d_lo = dphi;
+                } else {
+                    lo = t, f_lo = f, d_lo = dphi;
+                    t *= 2;
+                    continue;
+                }
+            } else {
+                if (f > f0 + c1 * t * slope0 || f >= f_lo) {
+                    hi = t, f_hi = f;
+                } else if (std::abs(dphi) <= -c2 * slope0) {
+                    f_new = f;
+                    return true;
+                } else {
+                    if (dphi * (hi - lo) >= 0) {
+                        hi = lo, f_hi = f_lo;
+                    }
+                    lo = t, f_lo = f, d_lo = dphi;
+                }
+            }
+            // 在[lo, hi]内用二次插值取下一个步长，并保证不落在端点附近
+            const double w = hi - lo;
+            const double denom = 2 * (f_hi - f_lo - d_lo * w);
+            t = denom > 0 ? lo - d_lo * w * w / denom : lo + w / 2;
+            const double a = std::min(lo, hi) + 0.1 * std::abs(w), b = std::max(lo, hi) - 0.1 * std::abs(w);
+            if (!(t >= a && t <= b)) {
+                t = lo + w / 2;
+            }
+        }
+        // 没有满足曲率条件，退回到满足充分下降条件的最好步长
+        if (lo > 0) {
+            double dphi;
+            f_new = trial(lo, dphi);
+            return true;
+        }
+        return false;
+    }
+};
+
+/**
+ * @brief Nelder-Mead单纯形法
+ * @param n 维度
+ * @note 使用随维度调整的系数(Gao & Han 2012)，高维时比经典系数收敛更稳定
+ */
+struct nelder_mead_t {
+    int n;
+    std::vector<std::vector<double>> simplex; // n + 1个顶点
+    std::vector<double> fx;
+    std::vector<int> order; // 顶点按函数值从小到大的下标
+    std::vector<double> centroid, xr, xe, xc;
+
+    nelder_mead_t(int n)
+        : n(n)
+        , simplex(n + 1, std::vector<double>(n))
+        , fx(n + 1)
+        , order(n + 1)
+        , centroid(n)
+        , xr(n)
+        , xe(n)
+        , xc(n)
+    {
+    }
+
+    /**
+     * @brief 从x出发最小化，结果写回x
+     * @param f 目标函数 double f(const std::vector<double>& x)
+     * @param eps 所有顶点的函数值之差和坐标之差都不超过eps时认为收敛
+     * @param max_eval 最大求值次数
+     */
+    template <typename F>
+    minimize_t minimize(const F& f, std::vector<double>& x, double eps = 1e-10, long long max_eval = 100000)
+    {
+        const double dn = std::max(n, 2); // 一维时退化为经典系数
+        const double alpha = 1, beta = 1 + 2 / dn, gamma = 0.75 - 0.5 / dn, delta = 1 - 1 / dn;
+        minimize_t res { 0, 0, 0, false };
+        auto eval = [&](const std::vector<double>& p) {
+            ++res.evals;
+            return f(p);
+        };
+        // 初始单纯形与fminsearch相同：每个坐标增加5%，为0的坐标增加0.00025
+        for (int i = 0; i <= n; ++i) {
+            std::copy(x.begin(), x.end(), simplex[i].begin());
+            if (i > 0) {
+                double& v = simplex[i][i - 1];
+                v = v != 0 ? v * 1.05 : 0.00025;
+            }
+            fx[i] = eval(simplex[i]);
+            order[i] = i;
+        }
+        auto replace_worst = [&](std::vector<double>& p, double fp) {
+            simplex[order[n]].swap(p);
+            fx[order[n]] = fp;
+        };
+        for (;; ++res.iterations) {
+            // 顶点几乎有序，插入排序只需O(n)
+            for (int i = 1; i <= n; ++i) {
+                for (int j = i; j > 0 && fx[order[j]] < fx[order[j - 1]]; --j) {
+                    std::swap(order[j], order[j - 1]);
+                }
+            }
+            const std::vector<double>& best = simplex[order[0]];
+            const std::vector<double>& worst = simplex[order[n]];
+            double fspread = fx[order[n]] - fx[order[0]], xspread = 0;
+            for (int i = 1; i <= n; ++i) {
+                for (int j = 0; j < n; ++j) {
+                    xspread = std::max(xspread, std::abs(simplex[order[i]][j] - best[j]));
+                }
+            }
+            if (fspread <= eps && xspread <= eps) {
+                res.converged = true;
+                break;
+            }
+            if (res.evals >= max_eval) {
+                break;
+            }
+            std::fill(centroid.begin(), centroid.end(), 0);
+            for (int i = 0; i < n; ++i) {
+                for (int j = 0; j < n; ++j) {
+                    centroid[j] += simplex[order[i]][j] / n;
+                }
+            }
+            for (int j = 0; j < n; ++j) {
+                xr[j] = centroid[j] + alpha * (centroid[j] - worst[j]);
+            }
+            const double fr = eval(xr);
+            if (fr < fx[order[0]]) {
+                for (int j = 0; j < n; ++j) {
+                    xe[j] = centroid[j] + beta * (xr[j] - centroid[j]);
+                }
+                const double fe = eval(xe);
+                if (fe < fr) {
+                    replace_worst(xe, fe);
+                } else {
+                    replace_worst(xr, fr);
+                }
+                continue;
+            }
+            if (fr < fx[order[n - 1]]) {
+                replace_worst(xr, fr);
+                continue;
+            }
+            // 收缩：反射点比最差点好时向反射点一侧收缩，否则向最差点一侧收缩
+            const bool outside = fr < fx[order[n]];
+            const std::vector<double>& target = outside ? xr : worst;
+            for (int j = 0; j < n; ++j) {
+                xc[j] = centroid[j] + gamma * (target[j] - centroid[j]);
+            }
+            const double fc = eval(xc);
+            if (fc < (outside ? fr : fx[order[n]])) {
+                replace_worst(xc, fc);
+                continue;
+            }
+            // 整体向最好的顶点收缩
+            for (int i = 1; i <= n; ++i) {
+                std::vector<double>& p = simplex[order[i]];
+                for (int j = 0; j < n; ++j) {
+                    p[j] = best[j] + delta * (p[j] - best[j]);
+                }
+                fx[order[i]] = eval(p);
+            }
+        }
+        std::copy(simplex[order[0]].begin(), simplex[order[0]].end(), x.begin());
+        res.value = fx[order[0]];
+        return res;
+    }
+};
+} // namespace demath
+
+#endif // MY_DEMATH_OPTIMIZE_HPP
@@ -0,0 +1,330 @@
+#ifndef MY_DEMATH_PRIME_HPP
+#define MY_DEMATH_PRIME_HPP
+/**
+ * @brief 素数与因数分解
+ *
+ * @brief 分段筛 for_each_prime, count_primes, primes_up_to (每段大小与L1缓存相当，可以多线程)
+ * @brief 确定性64位素性测试 is_prime (Miller-Rabin)
+ * @brief 因数分解 factorize (试除小素数 + Pollard-rho/Brent)
+ *
+ * @note 模乘都使用DEMATH_NUMBER.hpp中的montgomery_t，没有除法
+ *
+ * @example 使用示例
+ * int main()
+ * {
+ *     ThreadPool pool(8);
+ *     long long pi = demath::count_primes(1, 10000000000ULL, pool); // 455052511
+ *     bool p = demath::is_prime(1000000000000000003ULL);
+ *     std::vector<unsigned long long> f = demath::factorize(600851475143ULL); // 71 839 1471 6857
+ *     return 0;
+ * }
+ */
+
+#include "DEMATH.hpp"
+#include "DEMATH_NUMBER.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+namespace demath {
+/**
+ * @brief 埃氏筛求[2, n]中的所有素数
+ * @note 只适合n不太大的情况，更大的范围用for_each_prime
+ */
+inline std::vector<unsigned int> primes_up_to(unsigned int n)
+{
+    std::vector<unsigned int> primes;
+    if (n < 2) {
+        return primes;
+    }
+    std::vector<char> composite(n / 2 + 1, 0); // composite[i]对应奇数2i + 1
+    primes.push_back(2);
+    for (unsigned long long i = 3; i <= n; i += 2) {
+        if (!composite[i / 2]) {
+            primes.push_back(i);
+            for (unsigned long long j = i * i; j <= n; j += 2 * i) {
+                composite[j / 2] = 1;
+            }
+        }
+    }
+    return primes;
+}
+
+constexpr int SIEVE_SEGMENT = 1 << 15; // 每段的字节数(只筛奇数，每段覆盖2^16个整数)
+
+/**
+ * @brief 筛[lo, hi)中的奇数，lo为奇数，hi - lo <= 2 * SIEVE_SEGMENT
+ * @param primes 不超过sqrt(hi)的奇素数
+ * @param composite 输出，composite[i]表示lo + 2i是合数
+ */
+inline void sieve_segment(unsigned long long lo, unsigned long long hi, const std::vector<unsigned int>& primes,
+    std::vector<char>& composite)
+{
+    const unsigned long long size = (hi - lo + 1) / 2;
+    composite.assign(size, 0);
+    for (unsigned long long p : primes) {
+        if (p * p >= hi) {
+            break;
+        }
+        // 从max(p^2, 不小于lo的p的奇数倍)开始标记
+        unsigned long long start = std::max(p * p, (lo + p - 1) / p * p);
+        if (start % 2 == 0) {
+            start += p;
+        }
+        for (unsigned long long j = (start - lo) / 2; j < size; j += p) {
+            composite[j] = 1;
+        }
+    }
+}
+
+/**
+ * @brief 筛[lo, hi)需要的奇素数，即不超过sqrt(hi)的奇素数
+ */
+inline std::vector<unsigned int> sieve_base(unsigned long long hi)
+{
+    unsigned long long r = std::sqrt((double)hi);
+    while (r * r > hi) {
+        --r;
+    }
+    while ((r + 1) * (r + 1) <= hi) {
+        ++r;
+    }
+    std::vector<unsigned int> primes = primes_up_to(r);
+    if (!primes.empty()) {
+        primes.erase(primes.begin());
+    }
+    return primes;
+}
+
+/**
+ * @brief 按从小到大的顺序对[lo, hi)中的每个素数调用f(p)
+ * @note 额外内存为O(sqrt(hi))的基础素数加一个段，与区间长度无关
+ */
+template <typename F>
+void for_each_prime(unsigned long long lo, unsigned long long hi, F&& f)
+{
+    if (lo <= 2 && hi > 2) {
+        f(2ULL);
+    }
+    lo = std::max(lo, 3ULL) | 1;
+    if (lo >= hi) {
+        return;
+    }
+    const std::vector<unsigned int> primes = sieve_base(hi);
+    std::vector<char> composite;
+    for (unsigned long long seg = lo; seg < hi; seg += 2ULL * SIEVE_SEGMENT) {
+        const unsigned long long end = std::min(hi, seg + 2ULL * SIEVE_SEGMENT);
+        sieve_segment(seg, end, primes, composite);
+        for (size_t i = 0; i < composite.size(); ++i) {
+            if (!composite[i]) {
+                f(seg + 2 * i);
+            }
+        }
+    }
+}
+
+/**
+ * @brief 多线程分段筛，对[lo, hi)中的每个素数调用f(p)
+ * @param pool 线程池，不同的段在不同线程上筛
+ * @note f会被多个线程同时调用，调用顺序不确定，f需要是线程安全的
+ */
+template <typename F>
+void for_each_prime(unsigned long long lo, unsigned long long hi, ThreadPool& pool, F&& f)
+{
+    if (lo <= 2 && hi > 2) {
+        f(2ULL);
+    }
+    lo = std::max(lo, 3ULL) | 1;
+    if (lo >= hi) {
+        return;
+    }
+    const std::vector<unsigned int> primes = sieve_base(hi);
+    const unsigned long long span = 2ULL * SIEVE_SEGMENT;
+    const unsigned long long segments = (hi - lo + span - 1) / span;
+    parallel_for(pool, 0, segments, [&](size_t first, size_t last) {
+        std::vector<char> composite;
+        for (size_t s = first; s < last; ++s) {
+            const unsigned long long seg = lo + s * span, end = std::min(hi, seg + span);
+            sieve_segment(seg, end, primes, composite);
+            for (size_t i = 0; i < composite.size(); ++i) {
+                if (!composite[i]) {
+                    f(seg + 2 * i);
+                }
+            }
+        }
+    }, 1);
+}
+
+/**
+ * @brief 求[lo, hi)中素数的个数
+ */
+inline long long count_primes(unsigned long long lo, unsigned long long hi)
+{
+    long long count = 0;
+    for_each_prime(lo, hi, [&](unsigned long long) { ++count; });
+    return count;
+}
+
+/**
+ * @brief 多线程求[lo, hi)中素数的个数
+ */
+inline long long count_primes(unsigned long long lo, unsigned long long hi, ThreadPool& pool)
+{
+    if (lo >= hi) {
+        return 0;
+    }
+    std::atomic<long long> count(lo <= 2 && hi > 2 ? 1 : 0);
+    const unsigned long long odd = std::max(lo, 3ULL) | 1;
+    if (odd >= hi) {
+        return count;
+    }
+    const std::vector<unsigned int> primes = sieve_base(hi);
+    const unsigned long long span = 2ULL * SIEVE_SEGMENT;
+    const unsigned long long segments = (hi - odd + span - 1) / span;
+    parallel_for(pool, 0, segments, [&](size_t first, size_t last) {
+        std::vector<char> composite;
+        long long local = 0;
+        for (size_t s = first; s < last; ++s) {
+            const unsigned long long seg = odd + s * span;
+            sieve_segment(seg, std::min(hi, seg + span), primes, composite);
+            local += std::count(composite.begin(), composite.end(), 0);
+        }
+        count += local;
+    }, 1);
+    return count;
+}
+
+/**
+ * @brief 确定性64位Miller-Rabin素性测试
+ * @note 使用Jim Sinclair的7个底数，对所有n < 2^64都是确定的
+ * @note 时间复杂度O(7 * log(n))次Montgomery模乘
+ */
+inline bool is_prime(unsigned long long n)
+{
+    if (n < 64) {
+        return (0x28208a20a08a28acULL >> n) & 1; // 小于64的素数掩码
+    }
+    if (n % 2 == 0 || n % 3 == 0 || n % 5 == 0 || n % 7 == 0) {
+        return false;
+    }
+    const montgomery_t mont(n);
+    const unsigned long long one = mont.one(), minus_one = mont.sub(0, one);
+    unsigned long long d = n - 1;
+    const int s = __builtin_ctzll(d);
+    d >>= s;
+    for (unsigned long long a : { 2ULL, 325ULL, 9375ULL, 28178ULL, 450775ULL, 9780504ULL, 1795265022ULL }) {
+        a %= n;
+        if (a == 0) {
+            continue;
+        }
+        unsigned long long x = mont.pow(mont.to(a), d);
+        if (x == one || x == minus_one) {
+            continue;
+        }
+        bool composite = true;
+        for (int r = 1; r < s && composite; ++r) {
+            x = mont.mul(x, x);
+            composite = x != minus_one;
+        }
+        if (composite) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Pollard-rho求奇合数n的一个非平凡因子
+ * @note Brent判圈法，每128步才求一次gcd，迭代在Montgomery形式下进行
+ *       Montgomery形式与普通形式只差一个与n互质的因子2^64，不影响gcd
+ */
+inline unsigned long long pollard_rho(unsigned long long n)
+{
+    const montgomery_t mont(n);
+    constexpr int M = 128;
+    for (unsigned long long c = 1;; ++c) {
+        const unsigned long long cm = mont.to(c);
+        auto next = [&](unsigned long long x) { return mont.add(mont.mul(x, x), cm); };
+        auto diff = [](unsigned long long a, unsigned long long b) { return a > b ? a - b : b - a; };
+        unsigned long long x = 0, y = mont.to(2), ys = y, q = mont.one(), g = 1;
+        for (unsigned long long r = 1; g == 1; r <<= 1) {
+            x = y;
+            for (unsigned long long i = 0; i < r; ++i) {
+                y = next(y);
+            }
+            for (unsigned long long k = 0; k < r && g == 1; k += M) {
+                ys = y;
+                for (unsigned long long i = 0; i < M && i < r - k; ++i) {
+                    y = next(y);
+                    q = mont.mul(q, diff(x, y));
+                }
+                g = gcd(q, n);
+            }
+        }
+        if (g == n) {
+            // 一批中的乘积已经是n的倍数，从这一批的开头逐步回退
+            do {
+                ys = next(ys);
+                g = gcd(diff(x, ys), n);
+            } while (g == 1);
+        }
+        if (g != n) {
+            return g;
+        }
+    }
+}
+
+/**
+ * @brief 因数分解
+ * @return 从小到大排列的素因子(含重复)；n为0或1时返回空
+ * @note 先试除小于64的素数，剩下的部分用Miller-Rabin判断，合数用Pollard-rho分解
+ */
+inline std::vector<unsigned long long> factorize(unsigned long long n)
+{
+    std::vector<unsigned long long> factors;
+    if (n <= 1) {
+        return factors;
+    }
+    for (unsigned long long p : { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53, 59, 61 }) {
+        while (n % p == 0) {
+            factors.push_back(p);
+            n /= p;
+        }
+    }
+    unsigned long long stack[64];
+    int top = 0;
+    if (n > 1) {
+        stack[top++] = n;
+    }
+    while (top > 0) {
+        const unsigned long long m = stack[--top];
+        if (is_prime(m)) {
+            factors.push_back(m);
+            continue;
+        }
+        const unsigned long long d = pollard_rho(m);
+        stack[top++] = d;
+        stack[top++] = m / d;
+    }
+    std::sort(factors.begin(), factors.end());
+    return factors;
+}
+
+/**
+ * @brief 多线程分解一批数
+ * @return result[i]为values[i]的素因子
+ */
+inline std::vector<std::vector<unsigned long long>> factorize(const std::vector<unsigned long long>& values, ThreadPool& pool)
+{
+    std::vector<std::vector<unsigned long long>> result(values.size());
+    parallel_for(pool, 0, values.size(), [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            result[i] = factorize(values[i]);
+        }
+    }, 256);
+    return result;
+}
+} // namespace demath
+
+#endif // MY_DEMATH_PRIME_HPP
@@ -98,6 +98,30 @@ inline void write_double(double val, int precision = 6)
     optr += length;
 }
 
+inline void write_char(char c)
+{
+    *optr++ = c;
+}
+
+inline void write_string(const char* s, int length)
+{
+    // 写入字符串并追加空格，与write_int保持一致
+    memcpy(optr, s, length);
+    optr += length;
+    *optr++ = ' ';
+}
+
+constexpr int FLUSH_LIMIT = MAXBUFFER - 4096;
+inline void flush_if_full()
+{
+    // 缓冲区接近写满时写出已有内容但不改动末尾字符，用于流式输出大量数据
+    // 每次写入不超过4096字节时，在写入之间调用即可保证不越界
+    if (optr - obuffer >= FLUSH_LIMIT) {
+        fwrite(obuffer, 1, optr - obuffer, stdout);
+        optr = obuffer;
+    }
+}
+
 inline void flush()
 {
     if (optr != obuffer) {
@@ -14,9 +14,13 @@
  * modified is included with the above copyright notice.
  *
  */
+#ifndef MY_RANDOM_HPP
+#define MY_RANDOM_HPP
 #include "IO.hpp"
 #include <algorithm>
+#include <climits>
 #include <cmath>
+#include <cstdint>
 #include <cstdio>
 #include <iostream>
 #include <set>
@@ -629,4 +633,6 @@ const int random_t::lim = 25;
 const unsigned long long random_t::multiplier = 0x5DEECE66DLL; // 25214903917
 const unsigned long long random_t::addend = 0xBLL;
 const unsigned long long random_t::mask = (1LL << 48) - 1;
-int random_t::version = -1;
\ No newline at end of file
+int random_t::version = -1;
+
+#endif // MY_RANDOM_HPP
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include "Competition/DEMATH_LINALG.hpp"
+#include "Competition/RANDOM.hpp"
+#include <chrono>
+#include <cstdio>
+
+// 对比朴素三重循环与分块gemm的性能
+// g++ -std=c++17 -O2 -march=native -pthread -I. Competition2/2_matrix.cpp
+
+void gemm_naive(const demath::matrix_t& a, const demath::matrix_t& b, demath::matrix_t& c)
+{
+    for (int i = 0; i < a.rows; ++i) {
+        for (int j = 0; j < b.cols; ++j) {
+            double s = 0;
+            for (int k = 0; k < a.cols; ++k) {
+                s += a[i][k] * b[k][j];
+            }
+            c[i][j] = s;
+        }
+    }
+}
+
+template <typename F>
+double seconds(const F& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main()
+{
+    random_t rnd;
+    ThreadPool pool(std::thread::hardware_concurrency());
+    printf("%6s %12s %12s %12s %10s\n", "n", "naive GF/s", "gemm GF/s", "pool GF/s", "max err");
+    for (int n : { 128, 256, 512, 1024 }) {
+        demath::matrix_t a(n, n), b(n, n), c0(n, n), c1(n, n), c2(n, n);
+        for (auto& x : a.data) {
+            x = rnd.next(-1.0, 1.0);
+        }
+        for (auto& x : b.data) {
+            x = rnd.next(-1.0, 1.0);
+        }
+        const double flops = 2.0 * n * n * n;
+        double t0 = seconds([&] { gemm_naive(a, b, c0); });
+        double t1 = seconds([&] { demath::gemm(a, b, c1); });
+        double t2 = seconds([&] { demath::gemm(a, b, c2, pool); });
+        double err = 0;
+        for (size_t i = 0; i < c0.data.size(); ++i) {
+            err = std::max(err, std::max(std::abs(c0.data[i] - c1.data[i]), std::abs(c0.data[i] - c2.data[i])));
+        }
+        printf("%6d %12.2f %12.2f %12.2f %10.1e\n", n, flops / t0 * 1e-9, flops / t1 * 1e-9, flops / t2 * 1e-9, err);
+    }
+
+    // 解对称正定方程组 (A^T A + nI) x = b
+    const int n = 500;
+    demath::matrix_t a(n, n), at(n, n), spd(n, n);
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            at[j][i] = a[i][j] = rnd.next(-1.0, 1.0);
+        }
+    }
+    demath::gemm(at, a, spd);
+    for (int i = 0; i < n; ++i) {
+        spd[i][i] += n;
+    }
+    std::vector<double> x(n);
+    for (auto& v : x) {
+        v = rnd.next(-1.0, 1.0);
+    }
+    std::vector<double> b = demath::gemv(spd, x), y, z;
+    double t3 = seconds([&] { y = demath::lu_t(spd).solve(b); });
+    double t4 = seconds([&] { z = demath::cholesky_t(spd).solve(b); });
+    double e3 = 0, e4 = 0;
+    for (int i = 0; i < n; ++i) {
+        e3 = std::max(e3, std::abs(y[i] - x[i]));
+        e4 = std::max(e4, std::abs(z[i] - x[i]));
+    }
+    printf("lu %.3fs err %.1e, cholesky %.3fs err %.1e\n", t3, e3, t4, e4);
+    return 0;
+}
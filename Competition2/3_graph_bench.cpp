@@ -0,0 +1,174 @@
+#include "Competition/DEGEN.hpp"
+#include "Competition/DEGRAPH_BFS.hpp"
+#include "Competition/DEGRAPH_COMPONENT.hpp"
+#include "Competition/DEGRAPH_COMPRESS.hpp"
+#include "Competition/DEGRAPH_LOAD.hpp"
+#include "Competition/DEGRAPH_PATH.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 图算法基准测试：R-MAT、Erdős–Rényi、网格、长链四种图，边数从10^5开始每次乘10
+// 测量建图、BFS、单源最短路、连通分量的时间和各种表示占用的内存，每个测量输出一行JSON
+// g++ -std=c++17 -O2 -march=native -pthread -I. Competition2/3_graph_bench.cpp
+// ./a.out [最大边数，默认10^7] [线程数，默认hardware_concurrency]
+
+template <typename F>
+double seconds(const F& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 无向图，每条边存两个方向，m为有向边数
+struct workload_t {
+    std::string name;
+    int n = 0;
+    size_t m = 0;
+    std::vector<int> from, to;
+
+    void operator()(int u, int v)
+    {
+        from.push_back(u), to.push_back(v);
+        from.push_back(v), to.push_back(u);
+    }
+};
+
+workload_t* current;
+
+void report(const char* op, const char* repr, double t, size_t bytes = 0)
+{
+    printf("{\"graph\":\"%s\",\"vertices\":%d,\"edges\":%zu,\"op\":\"%s\",\"repr\":\"%s\",\"seconds\":%.6f,\"bytes\":%zu}\n",
+        current->name.c_str(), current->n, current->m, op, repr, t, bytes);
+    fflush(stdout);
+}
+
+void check(bool ok, const char* what)
+{
+    if (!ok) {
+        fprintf(stderr, "%s %d: %s mismatch\n", current->name.c_str(), current->n, what);
+    }
+}
+
+/**
+ * @brief 生成约m条有向边的图
+ * @note 平均度数：R-MAT和Erdős–Rényi为16，网格为4，链为2；链的节点编号随机打乱，没有局部性
+ */
+workload_t generate(const std::string& kind, long long m, random_t& rnd)
+{
+    workload_t w;
+    w.name = kind;
+    w.from.reserve(m + 4), w.to.reserve(m + 4);
+    if (kind == "rmat") {
+        const int scale = std::max(1, (int)std::lround(std::log2(m / 16.0)));
+        w.n = 1 << scale;
+        degen::rmat(rnd, scale, m / 2, w);
+    } else if (kind == "erdos_renyi") {
+        w.n = std::max<long long>(2, m / 16);
+        degen::erdos_renyi(rnd, w.n, m / 2, w);
+    } else if (kind == "grid") {
+        const int side = std::max(2, (int)std::sqrt(m / 4.0));
+        w.n = side * side;
+        degen::grid(side, side, w);
+    } else {
+        w.n = m / 2 + 1;
+        degen::chain(rnd, w.n, w, true);
+    }
+    w.m = w.from.size();
+    return w;
+}
+
+template <typename EdgeProps, typename VertexProps>
+size_t memory_size(const degraph::basic_graph_t<EdgeProps, VertexProps>& g)
+{
+    return (g.info.capacity() + g.next.capacity() + g.to.capacity()) * sizeof(int);
+}
+
+size_t memory_size(const degraph::csr_t& g)
+{
+    return (g.offset.capacity() + g.to.capacity() + g.id.capacity()) * sizeof(int);
+}
+
+void run(workload_t& w, ThreadPool& pool, random_t& rnd)
+{
+    current = &w;
+    const int n = w.n, s = w.from[0];
+
+    degraph::graph_t g;
+    double t = seconds([&] {
+        g = degraph::graph_t(n, w.m);
+        for (size_t e = 0; e < w.m; ++e) {
+            g.add_edge(w.from[e], w.to[e]);
+        }
+    });
+    report("build", "graph_t", t, memory_size(g));
+
+    degraph::csr_t csr;
+    t = seconds([&] { csr = degraph::build_csr(w.from, w.to, pool, n); });
+    report("build", "csr", t, memory_size(csr));
+    std::vector<int>().swap(w.from);
+    std::vector<int>().swap(w.to);
+
+    degraph::compressed_csr_t compressed;
+    t = seconds([&] { compressed = degraph::compressed_csr_t(csr); });
+    report("build", "compressed", t, compressed.memory_size());
+
+    std::vector<int> d0, d1, d2;
+    report("bfs", "graph_t", seconds([&] { d0 = degraph::bfs(g, s); }));
+    g = degraph::graph_t();
+    report("bfs", "csr", seconds([&] { d1 = degraph::bfs(csr, s); }));
+    report("bfs", "compressed", seconds([&] { d2 = degraph::bfs(compressed, s); }));
+    degraph::bfs_tree_t tree;
+    report("bfs", "csr_direction_optimizing", seconds([&] { tree = degraph::bfs_tree(csr, s, pool); }));
+    check(d0 == d1 && d1 == d2 && d1 == tree.dist, "bfs");
+    compressed = degraph::compressed_csr_t();
+
+    std::vector<int> weight(csr.edge_size());
+    for (int& x : weight) {
+        x = rnd.next(1, 100);
+    }
+    degraph::weighted_csr_t<int> wcsr;
+    t = seconds([&] { wcsr = degraph::weighted_csr_t<int>(csr, weight); });
+    report("build", "weighted_csr", t, memory_size(wcsr) + wcsr.weight.capacity() * sizeof(int));
+    std::vector<int> dist0, dist1;
+    report("sssp", "dijkstra", seconds([&] { dist0 = degraph::dijkstra(wcsr, s); }));
+    report("sssp", "delta_stepping", seconds([&] { dist1 = degraph::delta_stepping(wcsr, s, 50, pool); }));
+    check(dist0 == dist1, "sssp");
+    wcsr = degraph::weighted_csr_t<int>();
+
+    std::vector<int> c0, c1;
+    report("components", "afforest", seconds([&] { c0 = degraph::connected_components(csr, pool); }));
+    report("components", "union_find", seconds([&] {
+        degraph::union_find_t uf(n);
+        for (int u = 0; u < n; ++u) {
+            csr.for_each(u, [&](int v, int) { uf.unite(u, v); });
+        }
+        uf.compress();
+        c1 = std::move(uf.parent);
+    }));
+    check(c0 == c1, "components");
+}
+
+int main(int argc, char** argv)
+{
+    const long long max_edges = argc > 1 ? atoll(argv[1]) : 10000000;
+    const int threads = argc > 2 ? atoi(argv[2]) : std::max(1u, std::thread::hardware_concurrency());
+    ThreadPool pool(threads);
+    random_t rnd;
+    rnd.setSeed(20241105);
+    for (long long m = 100000; m <= max_edges; m *= 10) {
+        for (const char* kind : { "rmat", "erdos_renyi", "grid", "chain" }) {
+            workload_t w;
+            const double t = seconds([&] { w = generate(kind, m, rnd); });
+            current = &w;
+            report("generate", "edge_list", t, w.m * 2 * sizeof(int));
+            run(w, pool, rnd);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,820 @@
+#ifndef MY_THREADPOOL_HPP
+#define MY_THREADPOOL_HPP
+// study the following code
+// from https://github.com/progschj/ThreadPool
+// 在原版的基础上改为work stealing调度：
+// 每个worker有自己的Chase-Lev双端队列，worker中提交的任务放入自己的队列(无锁)，
+// 外部线程提交的任务放入加锁的注入队列，空闲的worker先取自己的队列，再取注入队列，最后从其他worker的队列偷取
+// 提交单个任务通常不调用malloc：任务对象和future的共享状态都从SmallObjectPool分配，可调用对象通常直接存放在任务对象内
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// 小对象内存池，按64字节的倍数分为4个大小类(64 ~ 256字节)，更大的直接用operator new，所有块按64字节对齐
+// 每个线程缓存一些空闲块，分配和释放通常不加锁；缓存过多时一批还给全局链表，缓存为空时从全局链表取一批
+// 在一个线程分配、另一个线程释放(如任务在提交线程分配、在worker释放)的块经过全局链表回到分配的线程
+// 池中的内存不还给系统
+class SmallObjectPool {
+public:
+    static constexpr size_t BLOCK = 64;
+    static constexpr size_t CLASSES = 4;
+    static constexpr size_t BATCH = 64; // 线程缓存与全局链表之间每次转移的块数
+
+    static void* allocate(size_t bytes)
+    {
+        if (bytes > BLOCK * CLASSES)
+            return ::operator new(bytes, std::align_val_t(BLOCK));
+        const size_t c = bytes ? (bytes - 1) / BLOCK : 0;
+        FreeList& list = cache().lists[c];
+        if (!list.head)
+            refill(list, c);
+        Node* node = list.head;
+        list.head = node->next;
+        --list.count;
+        return node;
+    }
+
+    static void deallocate(void* p, size_t bytes)
+    {
+        if (bytes > BLOCK * CLASSES) {
+            ::operator delete(p, std::align_val_t(BLOCK));
+            return;
+        }
+        const size_t c = bytes ? (bytes - 1) / BLOCK : 0;
+        FreeList& list = cache().lists[c];
+        Node* node = static_cast<Node*>(p);
+        node->next = list.head;
+        list.head = node;
+        if (++list.count >= 2 * BATCH)
+            release(list, c, BATCH);
+    }
+
+private:
+    struct Node {
+        Node* next;
+    };
+
+    struct FreeList {
+        Node* head = nullptr;
+        size_t count = 0;
+    };
+
+    struct Cache {
+        FreeList lists[CLASSES];
+        // 线程退出时把缓存的块还给全局链表
+        ~Cache()
+        {
+            for (size_t c = 0; c < CLASSES; ++c)
+                release(lists[c], c, lists[c].count);
+        }
+    };
+
+    struct Global {
+        std::mutex mutex;
+        FreeList lists[CLASSES];
+    };
+
+    static Cache& cache()
+    {
+        static thread_local Cache cache;
+        return cache;
+    }
+
+    // 不析构：静态对象析构之后，其他线程退出时仍可能归还缓存
+    static Global& global()
+    {
+        static Global* global = new Global;
+        return *global;
+    }
+
+    // 从from的头部取出最多n个块放入to
+    static void move(FreeList& from, FreeList& to, size_t n)
+    {
+        for (; n > 0 && from.head; --n) {
+            Node* node = from.head;
+            from.head = node->next;
+            --from.count;
+            node->next = to.head;
+            to.head = node;
+            ++to.count;
+        }
+    }
+
+    static void refill(FreeList& list, size_t c)
+    {
+        Global& g = global();
+        {
+            std::lock_guard<std::mutex> lock(g.mutex);
+            move(g.lists[c], list, BATCH);
+        }
+        if (list.head)
+            return;
+        // 全局链表也为空，一次申请BATCH个块
+        const size_t size = BLOCK * (c + 1);
+        char* slab = static_cast<char*>(::operator new(size * BATCH, std::align_val_t(BLOCK)));
+        for (size_t i = 0; i < BATCH; ++i) {
+            Node* node = reinterpret_cast<Node*>(slab + i * size);
+            node->next = list.head;
+            list.head = node;
+        }
+        list.count = BATCH;
+    }
+
+    static void release(FreeList& list, size_t c, size_t n)
+    {
+        Global& g = global();
+        std::lock_guard<std::mutex> lock(g.mutex);
+        move(list, g.lists[c], n);
+    }
+};
+
+// 从SmallObjectPool分配的分配器，用于std::promise的共享状态
+template <class T>
+struct PoolAllocator {
+    using value_type = T;
+
+    PoolAllocator() = default;
+    template <class U>
+    PoolAllocator(const PoolAllocator<U>&) { }
+
+    T* allocate(size_t n) { return static_cast<T*>(SmallObjectPool::allocate(n * sizeof(T))); }
+    void deallocate(T* p, size_t n) { SmallObjectPool::deallocate(p, n * sizeof(T)); }
+};
+
+template <class T, class U>
+bool operator==(const PoolAllocator<T>&, const PoolAllocator<U>&) { return true; }
+template <class T, class U>
+bool operator!=(const PoolAllocator<T>&, const PoolAllocator<U>&) { return false; }
+
+// 只能移动的无参任务，与std::function相比可以存放只能移动的对象(如std::promise)
+// 不超过INLINE字节的可调用对象直接存放在对象内，否则从SmallObjectPool分配；sizeof(UniqueTask)为64字节，正好一个块
+class UniqueTask {
+public:
+    static constexpr size_t INLINE = 56;
+
+    UniqueTask()
+        : ops(nullptr)
+    {
+    }
+
+    template <class F, class = typename std::enable_if<!std::is_same<typename std::decay<F>::type, UniqueTask>::value>::type>
+    UniqueTask(F&& f)
+    {
+        using T = typename std::decay<F>::type;
+        if constexpr (sizeof(T) <= INLINE && alignof(T) <= alignof(void*) && std::is_nothrow_move_constructible<T>::value) {
+            new (storage) T(std::forward<F>(f));
+            ops = &Inline<T>::ops;
+        } else {
+            void* p = SmallObjectPool::allocate(sizeof(T));
+            try {
+                *reinterpret_cast<T**>(storage) = new (p) T(std::forward<F>(f));
+            } catch (...) {
+                SmallObjectPool::deallocate(p, sizeof(T));
+                throw;
+            }
+            ops = &Heap<T>::ops;
+        }
+    }
+
+    UniqueTask(UniqueTask&& other) noexcept
+        : ops(other.ops)
+    {
+        if (ops)
+            ops->move(storage, other.storage);
+        other.ops = nullptr;
+    }
+
+    UniqueTask& operator=(UniqueTask&& other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            ops = other.ops;
+            if (ops)
+                ops->move(storage, other.storage);
+            other.ops = nullptr;
+        }
+        return *this;
+    }
+
+    UniqueTask(const UniqueTask&) = delete;
+    UniqueTask& operator=(const UniqueTask&) = delete;
+
+    ~UniqueTask() { reset(); }
+
+    explicit operator bool() const { return ops != nullptr; }
+
+    void operator()() { ops->invoke(storage); }
+
+private:
+    struct Ops {
+        void (*invoke)(void*);
+        void (*move)(void* to, void* from); // 移动到to并析构from
+        void (*destroy)(void*);
+    };
+
+    // 可调用对象存放在storage中
+    template <class T>
+    struct Inline {
+        static void invoke(void* p) { (*static_cast<T*>(p))(); }
+        static void move(void* to, void* from)
+        {
+            new (to) T(std::move(*static_cast<T*>(from)));
+            static_cast<T*>(from)->~T();
+        }
+        static void destroy(void* p) { static_cast<T*>(p)->~T(); }
+        static constexpr Ops ops = { invoke, move, destroy };
+    };
+
+    // storage中存放指向可调用对象的指针
+    template <class T>
+    struct Heap {
+        static T* get(void* p) { return *static_cast<T**>(p); }
+        static void invoke(void* p) { (*get(p))(); }
+        static void move(void* to, void* from) { *static_cast<T**>(to) = get(from); }
+        static void destroy(void* p)
+        {
+            T* f = get(p);
+            f->~T();
+            SmallObjectPool::deallocate(f, sizeof(T));
+        }
+        static constexpr Ops ops = { invoke, move, destroy };
+    };
+
+    void reset()
+    {
+        if (ops)
+            ops->destroy(storage);
+        ops = nullptr;
+    }
+
+    alignas(void*) unsigned char storage[INLINE];
+    const Ops* ops;
+};
+
+// Chase-Lev双端队列(Lê et al. 2013的C11版本)
+// 只有所有者调用push和pop，在bottom端操作；其他线程调用steal，在top端操作
+// 只有队列中剩最后一个元素时，pop和steal才需要用CAS竞争
+template <class T>
+class WorkStealingQueue {
+public:
+    WorkStealingQueue(size_t capacity = 256)
+        : top(0)
+        , bottom(0)
+    {
+        garbage.emplace_back(new Array(capacity));
+        array.store(garbage.back().get(), std::memory_order_relaxed);
+    }
+
+    // 所有者在bottom端放入x
+    void push(T x)
+    {
+        long long b = bottom.load(std::memory_order_relaxed);
+        long long t = top.load(std::memory_order_acquire);
+        Array* a = array.load(std::memory_order_relaxed);
+        if (b - t > (long long)a->capacity - 1) {
+            a = grow(a, t, b);
+        }
+        a->put(b, x);
+        bottom.store(b + 1, std::memory_order_release);
+    }
+
+    // 所有者从bottom端取出，队列为空时返回T()
+    T pop()
+    {
+        long long b = bottom.load(std::memory_order_relaxed) - 1;
+        Array* a = array.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        long long t = top.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return T();
+        }
+        T x = a->get(b);
+        if (t == b) {
+            // 最后一个元素，与steal竞争
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                x = T();
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return x;
+    }
+
+    // 其他线程从top端偷取，队列为空或竞争失败时返回T()
+    T steal()
+    {
+        long long t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        long long b = bottom.load(std::memory_order_acquire);
+        if (t >= b)
+            return T();
+        Array* a = array.load(std::memory_order_acquire);
+        T x = a->get(t);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return T();
+        return x;
+    }
+
+    bool empty() const
+    {
+        return bottom.load(std::memory_order_seq_cst) <= top.load(std::memory_order_seq_cst);
+    }
+
+private:
+    struct Array {
+        size_t capacity; // 2的幂
+        std::unique_ptr<std::atomic<T>[]> slots;
+
+        Array(size_t capacity)
+            : capacity(capacity)
+            , slots(new std::atomic<T>[capacity])
+        {
+        }
+        T get(long long i) const { return slots[i & (capacity - 1)].load(std::memory_order_relaxed); }
+        void put(long long i, T x) { slots[i & (capacity - 1)].store(x, std::memory_order_relaxed); }
+    };
+
+    // 容量翻倍，旧数组可能还在被steal读取，保留到队列析构时再释放
+    Array* grow(Array* a, long long t, long long b)
+    {
+        garbage.emplace_back(new Array(a->capacity * 2));
+        Array* bigger = garbage.back().get();
+        for (long long i = t; i < b; ++i)
+            bigger->put(i, a->get(i));
+        array.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    alignas(64) std::atomic<long long> top;
+    alignas(64) std::atomic<long long> bottom;
+    std::atomic<Array*> array;
+    std::vector<std::unique_ptr<Array>> garbage; // 只有所有者访问
+};
+
+class ThreadPool;
+
+// 定义在文件末尾，需要访问ThreadPool的私有成员
+template <class F>
+void parallel_for(ThreadPool& pool, size_t begin, size_t end, F&& f, size_t grain = 1024);
+
+class ThreadPool {
+public:
+    ThreadPool(size_t);
+
+    template <class F, class... Args>
+    auto enqueue(F&& f, Args&&... args)
+        -> std::future<typename std::result_of<F(Args...)>::type>;
+
+    // 提交一个任务，不创建future，开销最小
+    // 任务抛出的异常不会被捕获，会调用std::terminate
+    template <class F, class... Args>
+    void submit(F&& f, Args&&... args);
+
+    // 提交[first, last)中的每个无参可调用对象(复制)，外部线程只加一次锁
+    // 不超过64个任务时不分配内存(除了返回的vector)，InputIt不是前向迭代器时先复制到vector中
+    template <class InputIt>
+    auto enqueue_n(InputIt first, InputIt last)
+        -> std::vector<std::future<typename std::result_of<typename std::iterator_traits<InputIt>::reference()>::type>>;
+
+    // 与enqueue_n相同，但不创建future
+    template <class InputIt>
+    void submit_n(InputIt first, InputIt last);
+
+    ~ThreadPool();
+
+    size_t size() const { return workers.size(); }
+
+    // 在当前线程执行一个排队中的任务，没有任务时返回false
+    // 等待其他任务完成时调用，worker不会因为等待而闲置
+    bool run_pending();
+
+    // 当前线程是否为本线程池的worker
+    bool in_worker() const { return current_pool() == this; }
+
+private:
+    using Task = UniqueTask;
+
+    // 把f和参数打包成无参的可调用对象，与std::bind一样复制参数，调用时以左值传入
+    template <class F>
+    static auto bind_args(F&& f) { return std::forward<F>(f); }
+    template <class F, class Arg, class... Args>
+    static auto bind_args(F&& f, Arg&& arg, Args&&... args);
+
+    // 执行call并把结果或异常存入promise
+    template <class R, class F>
+    static void fulfill(std::promise<R>& promise, F& call);
+
+    template <class F>
+    static Task* make_task(F&& f);
+    static void release(Task* task) noexcept;
+    static void run(Task* task) noexcept;
+
+    // 用make(0), make(1), ..., make(n - 1)创建n个任务并一次提交，不超过64个时用栈上的数组
+    template <class Make>
+    void push_n(size_t n, Make&& make);
+    void push(Task* const* first, size_t n);
+
+    // parallel_for直接创建任务，不经过submit_n
+    template <class F>
+    friend void parallel_for(ThreadPool& pool, size_t begin, size_t end, F&& f, size_t grain);
+    void notify(size_t n);
+    Task* take(size_t self);
+    bool has_work() const;
+
+    // 当前线程所属的线程池和worker编号，不是worker时为nullptr
+    static ThreadPool*& current_pool()
+    {
+        static thread_local ThreadPool* pool = nullptr;
+        return pool;
+    }
+    static size_t& current_index()
+    {
+        static thread_local size_t index = 0;
+        return index;
+    }
+
+    // need to keep track of threads so we can join them
+    std::vector<std::thread> workers;
+    // 每个worker一个双端队列
+    std::vector<std::unique_ptr<WorkStealingQueue<Task*>>> queues;
+    // 注入队列，外部线程提交的任务，循环数组，大小为2的幂，只增不减
+    std::vector<Task*> tasks;
+    size_t front; // 队首在tasks中的下标
+    std::atomic<size_t> injected; // 注入队列中的任务数，不加锁也可以判断是否为空
+
+    // synchronization
+    std::mutex queue_mutex;
+    std::condition_variable condition;
+    std::atomic<int> sleeping; // 正在等待condition的worker数
+    bool stop;
+};
+
+// The constructor just launches some amount of workers
+inline ThreadPool::ThreadPool(size_t threads)
+    : front(0)
+    , injected(0)
+    , sleeping(0)
+    , stop(false)
+{
+    for (size_t i = 0; i < threads; ++i)
+        queues.emplace_back(new WorkStealingQueue<Task*>());
+    for (size_t i = 0; i < threads; ++i) {
+        // 向workers中添加线程，每个线程的任务是执行一个匿名函数，该匿名函数通过[this]
+        // 捕获了当前对象(ThreadPool实例)的this指针，因此可以在lambda表达式中访问
+        // ThreadPool的成员变量和成员函数
+        workers.emplace_back(
+            [this, i] {
+                current_pool() = this;
+                current_index() = i;
+                for (;;) {
+                    // 先自旋几次，短任务密集时不需要进入睡眠
+                    Task* task = nullptr;
+                    for (int spin = 0; spin < 64 && !task; ++spin) {
+                        task = take(i);
+                        if (!task)
+                            std::this_thread::yield();
+                    }
+                    if (task) {
+                        run(task);
+                        continue;
+                    }
+
+                    // 先登记sleeping再检查队列，与push中先放入任务再检查sleeping配对，不会错过唤醒
+                    std::unique_lock<std::mutex> lock(this->queue_mutex);
+                    this->sleeping.fetch_add(1);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    if (!this->has_work()) {
+                        if (this->stop) {
+                            this->sleeping.fetch_sub(1);
+                            return;
+                        }
+                        this->condition.wait(lock);
+                    }
+                    this->sleeping.fetch_sub(1);
+                }
+            });
+    }
+}
+
+// add new work item to the pool
+// F表示一个可调用对象的类型，Args是可变参数模板，表示可调用对象的参数
+template <class F, class... Args>
+auto ThreadPool::enqueue(F&& f, Args&&... args)
+    -> std::future<typename std::result_of<F(Args...)>::type>
+{
+    // std::result_of<F(Args...)>是一个函数模板，用于推导F(Args...)的返回值类型
+    // 例如 int foo(int, double), 则std::result_of<decltype(foo)(int, double)>::type是int
+    using return_type = typename std::result_of<F(Args...)>::type;
+
+    // std::promise在一个线程中设置结果，通过对应的std::future在另一个线程中获取
+    // 传入PoolAllocator，共享状态从SmallObjectPool分配；promise只能移动，所以任务用UniqueTask而不是std::function
+    std::promise<return_type> promise(std::allocator_arg, PoolAllocator<char>());
+    std::future<return_type> res = promise.get_future();
+    Task* task = make_task(
+        [promise = std::move(promise), call = bind_args(std::forward<F>(f), std::forward<Args>(args)...)]() mutable {
+            fulfill(promise, call);
+        });
+    push(&task, 1);
+    return res;
+}
+
+template <class F, class... Args>
+void ThreadPool::submit(F&& f, Args&&... args)
+{
+    Task* task = make_task(bind_args(std::forward<F>(f), std::forward<Args>(args)...));
+    push(&task, 1);
+}
+
+template <class InputIt>
+auto ThreadPool::enqueue_n(InputIt first, InputIt last)
+    -> std::vector<std::future<typename std::result_of<typename std::iterator_traits<InputIt>::reference()>::type>>
+{
+    using return_type = typename std::result_of<typename std::iterator_traits<InputIt>::reference()>::type;
+
+    if constexpr (!std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>::value) {
+        std::vector<typename std::iterator_traits<InputIt>::value_type> list(first, last);
+        return enqueue_n(list.begin(), list.end());
+    } else {
+        const size_t n = std::distance(first, last);
+        std::vector<std::future<return_type>> res;
+        res.reserve(n);
+        push_n(n, [&](size_t) {
+            std::promise<return_type> promise(std::allocator_arg, PoolAllocator<char>());
+            res.push_back(promise.get_future());
+            return make_task(
+                [promise = std::move(promise), call = bind_args(*first++)]() mutable {
+                    fulfill(promise, call);
+                });
+        });
+        return res;
+    }
+}
+
+template <class InputIt>
+void ThreadPool::submit_n(InputIt first, InputIt last)
+{
+    if constexpr (!std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>::value) {
+        std::vector<typename std::iterator_traits<InputIt>::value_type> list(first, last);
+        submit_n(list.begin(), list.end());
+    } else {
+        push_n(std::distance(first, last), [&](size_t) { return make_task(bind_args(*first++)); });
+    }
+}
+
+template <class F, class Arg, class... Args>
+auto ThreadPool::bind_args(F&& f, Arg&& arg, Args&&... args)
+{
+    return [f = std::forward<F>(f), args = std::make_tuple(std::forward<Arg>(arg), std::forward<Args>(args)...)]() mutable -> decltype(auto) {
+        return std::apply(f, args);
+    };
+}
+
+template <class R, class F>
+void ThreadPool::fulfill(std::promise<R>& promise, F& call)
+{
+    try {
+        if constexpr (std::is_void<R>::value) {
+            call();
+            promise.set_value();
+        } else {
+            promise.set_value(call());
+        }
+    } catch (...) {
+        promise.set_exception(std::current_exception());
+    }
+}
+
+template <class F>
+ThreadPool::Task* ThreadPool::make_task(F&& f)
+{
+    void* p = SmallObjectPool::allocate(sizeof(Task));
+    try {
+        return new (p) Task(std::forward<F>(f));
+    } catch (...) {
+        SmallObjectPool::deallocate(p, sizeof(Task));
+        throw;
+    }
+}
+
+inline void ThreadPool::release(Task* task) noexcept
+{
+    task->~Task();
+    SmallObjectPool::deallocate(task, sizeof(Task));
+}
+
+// submit的任务抛出异常时，noexcept使程序调用std::terminate；enqueue的任务在fulfill中捕获了异常
+inline void ThreadPool::run(Task* task) noexcept
+{
+    (*task)();
+    release(task);
+}
+
+template <class Make>
+void ThreadPool::push_n(size_t n, Make&& make)
+{
+    Task* local[64] = {};
+    std::unique_ptr<Task*[]> heap;
+    Task** batch = local;
+    if (n > 64) {
+        heap.reset(new Task*[n]);
+        batch = heap.get();
+    }
+    size_t i = 0;
+    try {
+        for (; i < n; ++i)
+            batch[i] = make(i);
+    } catch (...) {
+        while (i > 0)
+            release(batch[--i]);
+        throw;
+    }
+    push(batch, n);
+}
+
+// worker中提交的任务放入自己的队列，外部提交的任务放入注入队列
+inline void ThreadPool::push(Task* const* first, size_t n)
+{
+    if (n == 0)
+        return;
+    if (in_worker()) {
+        WorkStealingQueue<Task*>& queue = *queues[current_index()];
+        for (size_t i = 0; i < n; ++i)
+            queue.push(first[i]);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping.load(std::memory_order_relaxed) > 0) {
+            // 加锁保证睡眠的worker已经进入wait，notify不会丢失
+            { std::lock_guard<std::mutex> lock(queue_mutex); }
+            notify(n);
+        }
+        return;
+    }
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+
+        // don't allow enqueueing after stopping the pool
+        if (stop) {
+            for (size_t i = 0; i < n; ++i)
+                release(first[i]);
+            throw std::runtime_error("enqueue on stopped ThreadPool");
+        }
+
+        const size_t count = injected.load(std::memory_order_relaxed);
+        if (count + n > tasks.size()) {
+            // 扩容，按顺序搬到新数组的开头
+            size_t capacity = std::max<size_t>(64, tasks.size());
+            while (capacity < count + n)
+                capacity *= 2;
+            std::vector<Task*> bigger(capacity);
+            for (size_t i = 0; i < count; ++i)
+                bigger[i] = tasks[(front + i) & (tasks.size() - 1)];
+            tasks.swap(bigger);
+            front = 0;
+        }
+        for (size_t i = 0; i < n; ++i)
+            tasks[(front + count + i) & (tasks.size() - 1)] = first[i];
+        injected.fetch_add(n, std::memory_order_relaxed);
+    }
+    // worker登记sleeping和检查队列都在锁内，这里一定能看到已经登记的worker
+    if (sleeping.load(std::memory_order_relaxed) > 0)
+        notify(n);
+}
+
+// 唤醒n个睡眠的worker
+inline void ThreadPool::notify(size_t n)
+{
+    if (n >= workers.size())
+        condition.notify_all();
+    else
+        while (n--)
+            condition.notify_one();
+}
+
+// 取一个任务：自己的队列 -> 注入队列 -> 从其他worker偷取，self为worker编号，外部线程为size()
+inline ThreadPool::Task* ThreadPool::take(size_t self)
+{
+    const size_t n = queues.size();
+    if (self < n) {
+        if (Task* task = queues[self]->pop())
+            return task;
+    }
+    if (injected.load(std::memory_order_relaxed) > 0) {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        if (injected.load(std::memory_order_relaxed) > 0) {
+            Task* task = tasks[front];
+            front = (front + 1) & (tasks.size() - 1);
+            injected.fetch_sub(1, std::memory_order_relaxed);
+            return task;
+        }
+    }
+    // 从随机位置开始依次尝试偷取，避免所有空闲的worker都去偷同一个队列
+    static thread_local unsigned long long seed = std::hash<std::thread::id>()(std::this_thread::get_id()) | 1;
+    seed ^= seed << 13, seed ^= seed >> 7, seed ^= seed << 17;
+    for (size_t i = 0, start = n ? seed % n : 0; i < n; ++i) {
+        const size_t victim = (start + i) % n;
+        if (victim == self)
+            continue;
+        if (Task* task = queues[victim]->steal())
+            return task;
+    }
+    return nullptr;
+}
+
+inline bool ThreadPool::has_work() const
+{
+    if (injected.load(std::memory_order_relaxed) > 0)
+        return true;
+    for (auto& queue : queues)
+        if (!queue->empty())
+            return true;
+    return false;
+}
+
+inline bool ThreadPool::run_pending()
+{
+    Task* task = take(in_worker() ? current_index() : queues.size());
+    if (!task)
+        return false;
+    run(task);
+    return true;
+}
+
+// the destructor joins all threads
+inline ThreadPool::~ThreadPool()
+{
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        stop = true;
+    }
+    condition.notify_all();
+    for (std::thread& worker : workers)
+        worker.join();
+}
+
+// 将[begin, end)分成若干块交给线程池执行，f(lo, hi)处理一块，返回时所有块都已完成
+// 块数为线程数的4倍以平衡负载，grain为每块的最少元素数，元素太少时直接在当前线程执行
+// 等待时当前线程也会执行排队中的任务，因此可以在线程池的任务中嵌套调用
+template <class F>
+void parallel_for(ThreadPool& pool, size_t begin, size_t end, F&& f, size_t grain)
+{
+#ifdef GXY_DEBUG
+    if (grain == 0) {
+        std::cerr << "parallel_for: grain must be positive\n";
+        throw std::runtime_error("parallel_for: grain must be positive");
+    }
+#endif
+    if (begin >= end)
+        return;
+    size_t n = end - begin;
+    size_t chunks = std::min(pool.size() * 4, n / grain);
+    if (chunks <= 1) {
+        f(begin, end);
+        return;
+    }
+    // 各块共享的状态，用计数器代替future等待完成，第一个异常在所有块完成后重新抛出
+    struct State {
+        typename std::remove_reference<F>::type& f;
+        std::atomic<size_t> remaining;
+        std::atomic<bool> failed;
+        std::exception_ptr error;
+    } state { f, chunks, false, nullptr };
+    struct Chunk {
+        State* state;
+        size_t lo, hi;
+        void operator()() const
+        {
+            try {
+                state->f(lo, hi);
+            } catch (...) {
+                if (!state->failed.exchange(true))
+                    state->error = std::current_exception();
+            }
+            state->remaining.fetch_sub(1, std::memory_order_release);
+        }
+    };
+    pool.push_n(chunks, [&](size_t c) {
+        return ThreadPool::make_task(Chunk { &state, begin + n * c / chunks, begin + n * (c + 1) / chunks });
+    });
+    while (state.remaining.load(std::memory_order_acquire) > 0)
+        if (!pool.run_pending())
+            std::this_thread::yield();
+    if (state.error)
+        std::rethrow_exception(state.error);
+}
+
+#endif // MY_THREADPOOL_HPP